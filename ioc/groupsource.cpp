@@ -52,14 +52,21 @@ GroupSource::GroupSource()
         epicsGuard<epicsMutex> G(config.groupMapMutex);
 
         // For each defined group, add group name to the list of all records
+        groups.reserve(config.groupMap.size());
         for (auto& groupMapEntry: config.groupMap) {
             auto& groupName = groupMapEntry.first;
             names->insert(groupName);
+            groups.insert(groupName, &groupMapEntry.second);
         }
     }
 
     allRecords.names = names;
 
+    filter = std::make_shared<server::SearchFilter>(names->size());
+    for (auto& name: *names) {
+        filter->add(name);
+    }
+
     // Start event pump
     if (!eventContext) {
         throw std::runtime_error("Group Source: Event Context failed to initialise: db_init_events()");
@@ -82,9 +89,8 @@ void GroupSource::onCreate(std::unique_ptr<server::ChannelControl>&& channelCont
     log_debug_printf(_logname, "Accepting channel for '%s'\n", sourceName.c_str());
 
     // Create callbacks for handling requests and group subscriptions
-    auto it(config.groupMap.find(sourceName));
-    if(it != config.groupMap.end()) {
-        auto& group(it->second);
+    if(auto found = groups.find(sourceName)) {
+        auto& group(**found);
         channelControl->onOp([&](std::unique_ptr<server::ConnectOp>&& channelConnectOperation) {
             onOp(group, std::move(channelConnectOperation));
         });
@@ -106,7 +112,7 @@ void GroupSource::onCreate(std::unique_ptr<server::ChannelControl>&& channelCont
  */
 void GroupSource::onSearch(Search& searchOperation) {
     for (auto& pv: searchOperation) {
-        if (allRecords.names->count(pv.name()) == 1) {
+        if (groups.find(pv.name(), pv.length(), pv.hash())) {
             pv.claim();
             log_debug_printf(_logname, "Claiming '%s'\n", pv.name());
         }
@@ -14,6 +14,7 @@
 #include "groupsrcsubscriptionctx.h"
 #include "iocsource.h"
 #include "securityclient.h"
+#include "utilpvt.h"
 
 namespace pvxs {
 namespace ioc {
@@ -33,16 +34,24 @@ public:
         return allRecords;
     }
 
+    std::shared_ptr<const server::SearchFilter> searchFilter() final {
+        return filter;
+    }
+
     void onSearch(Search& searchOperation) final;
     void show(std::ostream& outputStream) final;
 
 private:
     // List of all database records that this single source serves
     List allRecords;
+    // allRecords for fast rejection of searches
+    std::shared_ptr<server::SearchFilter> filter;
     // The event context for all subscriptions
     DBEventContext eventContext;
 
     IOCGroupConfig& config;
+    // groups in config.groupMap, indexed by name
+    impl::NameIndex<Group*> groups;
 
     // Handles all get, put and subscribe requests
     static void onOp(Group& group, std::unique_ptr<server::ConnectOp>&& channelConnectOperation);
@@ -21,6 +21,7 @@
 #include <pvxs/nt.h>
 #include <pvxs/source.h>
 #include <dbNotify.h>
+#include <epicsGuard.h>
 
 #include "dbentry.h"
 #include "dberrormessage.h"
@@ -42,28 +43,45 @@ DEFINE_LOGGER(_logname, "pvxs.ioc.single.source");
 DEFINE_INST_COUNTER(PutOperationCache);
 DEFINE_INST_COUNTER(SingleInfo);
 
+typedef epicsGuard<epicsMutex> Guard;
+
 namespace {
 
-void subscriptionCallback(SingleSourceSubscriptionCtx* subscriptionContext,
+void subscriptionCallback(SingleSourceSharedSubscription* subscription,
                           UpdateType::type change,
+                          bool isProperty,
                           dbChannel* pChannel,
                           struct db_field_log* pDbFieldLog) noexcept {
     try {
+        Guard G(subscription->eventLock);
+        (isProperty ? subscription->hadPropertyEvent : subscription->hadValueEvent) = true;
+
         // Get the current value of this subscription
         // We simply merge new field changes onto this value as events occur
-        auto currentValue = subscriptionContext->currentValue;
+        auto& currentValue = subscription->currentValue;
 
         {
-            DBLocker F(dbChannelRecord(subscriptionContext->info->chan));
+            DBLocker F(dbChannelRecord(subscription->info->chan));
             // TODO MappingInfo::nsecMask
             IOCSource::get(currentValue, MappingInfo(), Value(), change, pChannel, pDbFieldLog);
         }
+        subscription->completeValue.assign(currentValue);
 
         // Make sure that the initial subscription update has occurred on both channels before continuing
         // As we make two initial updates when opening a new subscription, we need both to have completed before continuing
-        if (subscriptionContext->hadValueEvent && subscriptionContext->hadPropertyEvent) {
-            // Return value
-            subscriptionContext->subscriptionControl->post(currentValue.clone());
+        if (subscription->hadValueEvent && subscription->hadPropertyEvent) {
+            // Return value.  The same update is posted to all subscribers
+            auto update(subscription->updates.create());
+            update.assign(currentValue);
+            if (subscription->running.size() == 1u) {
+                subscription->running.front()->post(update);
+            } else if (!subscription->running.empty()) {
+                // encode once for all subscribers
+                server::MonitorFanout F(update);
+                for (auto subscriptionControl : subscription->running) {
+                    subscriptionControl->post(update);
+                }
+            }
             currentValue.unmark();
         }
     } catch(std::exception& e) {
@@ -73,8 +91,7 @@ void subscriptionCallback(SingleSourceSubscriptionCtx* subscriptionContext,
 
 void subscriptionValueCallback(void* userArg, struct dbChannel* pChannel,
                                int, struct db_field_log* pDbFieldLog) noexcept {
-    auto subscriptionContext = (SingleSourceSubscriptionCtx*)userArg;
-    subscriptionContext->hadValueEvent = true;
+    auto subscription = (SingleSourceSharedSubscription*)userArg;
     auto change = UpdateType::type(UpdateType::Value | UpdateType::Alarm);
 #if EPICS_VERSION_INT >= VERSION_INT(7, 0, 6, 0)
     if(pDbFieldLog) {
@@ -82,28 +99,23 @@ void subscriptionValueCallback(void* userArg, struct dbChannel* pChannel,
         change = UpdateType::type(pDbFieldLog->mask & UpdateType::Everything);
     }
 #endif
-    subscriptionCallback(subscriptionContext, change, pChannel, pDbFieldLog);
+    subscriptionCallback(subscription, change, false, pChannel, pDbFieldLog);
 }
 
 void subscriptionPropertiesCallback(void* userArg, struct dbChannel* pChannel, int,
                                     struct db_field_log* pDbFieldLog) noexcept {
-    auto subscriptionContext = (SingleSourceSubscriptionCtx*)userArg;
-    subscriptionContext->hadPropertyEvent = true;
-    subscriptionCallback(subscriptionContext, UpdateType::Property, pChannel, pDbFieldLog);
+    auto subscription = (SingleSourceSharedSubscription*)userArg;
+    subscriptionCallback(subscription, UpdateType::Property, true, pChannel, pDbFieldLog);
 }
 
 /**
- * Called by the framework when a client subscribes to a channel.  We intercept the call before this function is called
- * to add a new subscription context with a value prototype matching the channel definition.
+ * DBE mask for value events from the "record._options.DBE" pvRequest option
  *
- * @param subscriptionContext a new subscription context with a value prototype matching the channel
- * @param subscriptionOperation the channel subscription operation
+ * @param pvReq the pvRequest of a subscription
+ * @return the DBE mask
  */
-void onSubscribe(const std::shared_ptr<SingleSourceSubscriptionCtx>& subscriptionContext,
-                 const DBEventContext& eventContext,
-                 std::unique_ptr<server::MonitorSetupOp>&& subscriptionOperation)
+unsigned subscriptionMask(const Value& pvReq)
 {
-    auto pvReq(subscriptionOperation->pvRequest());
     unsigned dbe = 0;
     if(auto fld = pvReq["record._options.DBE"].ifMarked()) {
         switch(fld.type().kind()) {
@@ -129,40 +141,30 @@ void onSubscribe(const std::shared_ptr<SingleSourceSubscriptionCtx>& subscriptio
     dbe &= (DBE_VALUE | DBE_ARCHIVE | DBE_ALARM);
     if(!dbe)
         dbe = DBE_VALUE | DBE_ALARM;
+    return dbe;
+}
 
+/**
+ * Called by the framework when a client subscribes to a channel.  We intercept the call before this function is called
+ * to add a new subscription context joined to the shared subscription for this channel and DBE mask.
+ *
+ * @param subscriptionContext a new subscription context
+ * @param subscriptionOperation the channel subscription operation
+ */
+void onSubscribe(const std::shared_ptr<SingleSourceSubscriptionCtx>& subscriptionContext,
+                 std::unique_ptr<server::MonitorSetupOp>&& subscriptionOperation)
+{
     // inform peer of data type and acquire control of the subscription queue
-    subscriptionContext->subscriptionControl = subscriptionOperation->connect(subscriptionContext->currentValue);
-
-    IOCSource::initialize(subscriptionContext->currentValue,
-                          *subscriptionContext->info,
-                          subscriptionContext->info->chan);
-
-    // Two subscription are made for pvxs
-    // first subscription is for Value changes
-    subscriptionContext->pValueEventSubscription.subscribe(eventContext.get(),
-                                                           subscriptionContext->info->chan,
-                                                           subscriptionValueCallback,
-                                                           subscriptionContext.get(),
-                                                           dbe
-                                                           );
-    // second subscription is for Property changes
-    subscriptionContext->pPropertiesEventSubscription.subscribe(eventContext.get(),
-                                                                subscriptionContext->pPropertiesChannel,
-                                                                subscriptionPropertiesCallback,
-                                                                subscriptionContext.get(),
-                                                                DBE_PROPERTY
-                                                                );
+    subscriptionContext->subscriptionControl = subscriptionOperation->connect(subscriptionContext->shared->currentValue);
 
     // If all goes well, Set up handlers for start and stop monitoring events
     // The subscription context is being kept alive because it is being bound into some internal storage by onStart
     subscriptionContext->subscriptionControl->onStart([subscriptionContext](bool isStarting) {
         if (isStarting) {
             subscriptionContext->eventsEnabled = true;
-            subscriptionContext->pValueEventSubscription.enable();
-            subscriptionContext->pPropertiesEventSubscription.enable();
+            subscriptionContext->shared->start(subscriptionContext->subscriptionControl.get());
         } else {
-            subscriptionContext->pValueEventSubscription.disable();
-            subscriptionContext->pPropertiesEventSubscription.disable();
+            subscriptionContext->shared->stop(subscriptionContext->subscriptionControl.get());
             subscriptionContext->eventsEnabled = false;
         }
     });
@@ -389,6 +391,12 @@ SingleSource::SingleSource()
 
     allRecords.names = names;
 
+    // channel names are "record" or "record.FIELD" (with modifiers)
+    filter = std::make_shared<server::SearchFilter>(names->size(), ".");
+    for (auto& name: *names) {
+        filter->add(name);
+    }
+
     // Start event pump
     if (!eventContext) {
         throw std::runtime_error("Single Source: Event Context failed to initialise: db_init_events()");
@@ -428,18 +436,82 @@ void SingleSource::onCreate(std::unique_ptr<server::ChannelControl>&& channelCon
                 onOp(sInfo, valuePrototype, std::move(channelConnectOperation));
             });
 
+    // Server side filters (eg. decimate) keep per-dbChannel state, which must not be shared between clients
+    dbChannel* chan = sInfo->chan;
+    const bool filtered = ellCount(&chan->filters) != 0
+            || ellCount(&chan->pre_chain) != 0 || ellCount(&chan->post_chain) != 0;
+    std::string name(channelControl->name());
+
     // binding 'this' safe as Server shutdown will close connections before dropping Source
     channelControl
-            ->onSubscribe([this, valuePrototype, sInfo](
+            ->onSubscribe([this, valuePrototype, name, filtered](
                     std::unique_ptr<server::MonitorSetupOp>&& subscriptionOperation) {
                 // The subscription must be kept alive
                 // We accomplish this further on during the binding of the onStart()
-                auto subscriptionContext(std::make_shared<SingleSourceSubscriptionCtx>(sInfo));
-                subscriptionContext->currentValue = valuePrototype.cloneEmpty();
-                onSubscribe(subscriptionContext, eventContext, std::move(subscriptionOperation));
+                auto dbe(subscriptionMask(subscriptionOperation->pvRequest()));
+                auto subscriptionContext(std::make_shared<SingleSourceSubscriptionCtx>(
+                        sharedSubscription(name, dbe, valuePrototype, !filtered)));
+                onSubscribe(subscriptionContext, std::move(subscriptionOperation));
             });
 }
 
+/**
+ * Find, or create, the subscription shared by all clients monitoring a channel name with a DBE mask.
+ * The shared subscription is destroyed once released by its last subscriber.
+ * Expired entries are removed during later calls.
+ *
+ * @param name the full channel name as requested by the client, including any server side filters
+ * @param dbe the DBE mask for value events, from the pvRequest
+ * @param valuePrototype the value prototype for this channel
+ * @param share false to always create a new subscription, which is not shared with other clients
+ * @return the shared subscription
+ */
+std::shared_ptr<SingleSourceSharedSubscription> SingleSource::sharedSubscription(const std::string& name, unsigned dbe,
+                                                                                  const Value& valuePrototype,
+                                                                                  bool share) {
+    Guard G(subscriptionsLock);
+
+    std::weak_ptr<SingleSourceSharedSubscription> unshared;
+    auto& entry = share ? subscriptions[std::make_pair(name, dbe)] : unshared;
+    if (auto subscription = entry.lock()) {
+        return subscription;
+    }
+
+    if (share && subscriptions.size() > 2u * subscriptionsSwept + 16u) {
+        // occasionally remove entries released by their last subscriber
+        for (auto it = subscriptions.begin(); it != subscriptions.end();) {
+            if (it->second.expired() && &it->second != &entry)
+                it = subscriptions.erase(it);
+            else
+                ++it;
+        }
+        subscriptionsSwept = subscriptions.size();
+    }
+
+    auto subscription(std::make_shared<SingleSourceSharedSubscription>(name, dbe, valuePrototype));
+
+    IOCSource::initialize(subscription->currentValue, *subscription->info, subscription->info->chan);
+
+    // Two subscription are made for pvxs
+    // first subscription is for Value changes
+    subscription->pValueEventSubscription.subscribe(eventContext.get(),
+                                                    subscription->info->chan,
+                                                    subscriptionValueCallback,
+                                                    subscription.get(),
+                                                    dbe
+                                                    );
+    // second subscription is for Property changes
+    subscription->pPropertiesEventSubscription.subscribe(eventContext.get(),
+                                                         subscription->pPropertiesChannel,
+                                                         subscriptionPropertiesCallback,
+                                                         subscription.get(),
+                                                         DBE_PROPERTY
+                                                         );
+
+    entry = subscription;
+    return subscription;
+}
+
 /**
  * Respond to search requests.  For each matching pv, claim that pv
  *
@@ -10,6 +10,11 @@
 #ifndef PVXS_SINGLESOURCE_H
 #define PVXS_SINGLESOURCE_H
 
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+
 #include <dbNotify.h>
 #include <dbEvent.h>
 
@@ -33,14 +38,29 @@ public:
         return allRecords;
     }
 
+    std::shared_ptr<const server::SearchFilter> searchFilter() final {
+        return filter;
+    }
+
     void onSearch(Search& searchOperation) final;
     void show(std::ostream& outputStream) final;
 
 private:
+    std::shared_ptr<SingleSourceSharedSubscription> sharedSubscription(const std::string& name, unsigned dbe,
+                                                                       const Value& valuePrototype, bool share);
+
     // List of all database records that this single source serves
     List allRecords;
+    // allRecords for fast rejection of searches
+    std::shared_ptr<server::SearchFilter> filter;
     // The event context for all subscriptions
     DBEventContext eventContext;
+    // Subscriptions shared by clients monitoring the same full channel name with the same DBE mask.
+    // Channels with server side filters are never shared.
+    epicsMutex subscriptionsLock;
+    std::map<std::pair<std::string, unsigned>, std::weak_ptr<SingleSourceSharedSubscription>> subscriptions;
+    // size of subscriptions after last removal of expired entries
+    size_t subscriptionsSwept = 0u;
 };
 
 } // ioc
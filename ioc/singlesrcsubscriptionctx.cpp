@@ -7,22 +7,105 @@
  *
  */
 
+#include <algorithm>
+
+#include <epicsGuard.h>
+
 #include "singlesrcsubscriptionctx.h"
 #include "utilpvt.h"
 
 namespace pvxs {
 namespace ioc {
 
+DEFINE_INST_COUNTER(SingleSourceSharedSubscription);
 DEFINE_INST_COUNTER(SingleSourceSubscriptionCtx);
 
+typedef epicsGuard<epicsMutex> Guard;
+
+/**
+ * Constructor for a shared subscription.  Opens separate channels for value and property events.
+ *
+ * @param name the channel name, including any server side filters
+ * @param dbe the DBE mask for value events
+ * @param valuePrototype a value prototype for the channel
+ */
+SingleSourceSharedSubscription::SingleSourceSharedSubscription(const std::string& name, unsigned dbe,
+                                                               const Value& valuePrototype)
+    :key(name, dbe)
+    ,info(std::make_shared<SingleInfo>(Channel(name)))
+    ,pPropertiesChannel(name)
+    ,updates(valuePrototype, 8u)
+    ,currentValue(valuePrototype.cloneEmpty())
+    ,completeValue(valuePrototype.cloneEmpty())
+{}
+
+SingleSourceSharedSubscription::~SingleSourceSharedSubscription()
+{
+    assert(running.empty());
+    // must db_cancel_event() before members used by callbacks are destroyed
+    cancel();
+}
+
+/**
+ * Add a subscriber.  The first subscriber enables db events.  A later subscriber
+ * receives the latest complete value, or waits for the initial events if these are pending.
+ *
+ * @param subscriptionControl the subscriber
+ */
+void SingleSourceSharedSubscription::start(server::MonitorControlOp* subscriptionControl)
+{
+    Guard S(startLock);
+    {
+        Guard G(eventLock);
+
+        if(!running.empty()) {
+            if(hadValueEvent && hadPropertyEvent)
+                subscriptionControl->post(completeValue.clone());
+            running.push_back(subscriptionControl);
+            return;
+        }
+
+        // wait for both initial events, which will be posted together.
+        hadValueEvent = hadPropertyEvent = false;
+        running.push_back(subscriptionControl);
+    }
+
+    // not holding eventLock, as db_post_single_event() locks the record
+    pValueEventSubscription.enable();
+    pPropertiesEventSubscription.enable();
+}
+
+/**
+ * Remove a subscriber.  db events are disabled when no subscribers remain.
+ *
+ * @param subscriptionControl the subscriber
+ */
+void SingleSourceSharedSubscription::stop(server::MonitorControlOp* subscriptionControl)
+{
+    Guard S(startLock);
+    {
+        Guard G(eventLock);
+
+        auto it(std::find(running.begin(), running.end(), subscriptionControl));
+        if(it==running.end())
+            return;
+        running.erase(it);
+
+        if(!running.empty())
+            return;
+    }
+
+    pValueEventSubscription.disable();
+    pPropertiesEventSubscription.disable();
+}
+
 /**
- * Constructor for single source subscription context using a pointer to a db channel
+ * Constructor for single source subscription context, which is one subscriber to a shared subscription
  *
- * @param dbChannelSharedPtr pointer to the db channel to use to construct the single source subscription context
+ * @param shared the shared subscription
  */
-SingleSourceSubscriptionCtx::SingleSourceSubscriptionCtx(const std::shared_ptr<SingleInfo> &sInfo)
-    :pPropertiesChannel(dbChannelName(sInfo->chan))
-    ,info(sInfo)
+SingleSourceSubscriptionCtx::SingleSourceSubscriptionCtx(const std::shared_ptr<SingleSourceSharedSubscription>& shared)
+    :shared(shared)
 {}
 } // iocs
 } // pvxs
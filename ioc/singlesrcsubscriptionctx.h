@@ -10,6 +10,13 @@
 #ifndef PVXS_SINGLESRCSUBSCRIPTIONCTX_H
 #define PVXS_SINGLESRCSUBSCRIPTIONCTX_H
 
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <epicsMutex.h>
+
+#include <pvxs/data.h>
 #include <pvxs/source.h>
 
 #include "channel.h"
@@ -30,29 +37,66 @@ struct SingleInfo : public MappingInfo {
 };
 
 /**
- * A subscription context
+ * A subscription to one channel shared by all clients monitoring the same channel name
+ * with the same DBE mask.  Each event is read and converted once,
+ * and the same update is posted to every started subscriber.
  */
-class SingleSourceSubscriptionCtx : public SubscriptionCtx {
+class SingleSourceSharedSubscription : public SubscriptionCtx {
 
 public:
-    explicit SingleSourceSubscriptionCtx(const std::shared_ptr<SingleInfo>& sInfo);
+    SingleSourceSharedSubscription(const std::string& name, unsigned dbe, const Value& valuePrototype);
+    ~SingleSourceSharedSubscription();
+
+    // Begin, or stop, delivering updates to a subscriber
+    void start(server::MonitorControlOp* subscriptionControl);
+    void stop(server::MonitorControlOp* subscriptionControl);
 
+    // channel name and DBE mask
+    const std::pair<std::string, unsigned> key;
+    const std::shared_ptr<SingleInfo> info;
     // extra dbChannel* to have a distinct state for any server side filters.  (eg. decimate)
     const Channel pPropertiesChannel;
+    // updates posted to subscribers.  Re-used once released by all subscriber queues.
+    const ValuePool updates;
+
+    // Serializes start() and stop(), so that db events are enabled and disabled in order.
+    // Taken before eventLock.  Not held by event callbacks, so may be held while
+    // db_post_single_event() takes the record lock.
+    epicsMutex startLock{};
+
+    epicsMutex eventLock{};
+    // Further members guarded by eventLock
 
     // This is used to store the current value.  Each subscription event simply merges
     // new fields into this value
     Value currentValue{};
-    std::shared_ptr<SingleInfo> info;
-    epicsMutex eventLock{};
+    // Latest value of every field updated so far.  Initial update for a subscriber
+    // which starts after the first events.
+    Value completeValue{};
+    // started subscribers.  Each is removed by stop() before it is destroyed.
+    // cf. ~SingleSourceSubscriptionCtx()
+    std::vector<server::MonitorControlOp*> running;
+    INST_COUNTER(SingleSourceSharedSubscription);
+};
+
+/**
+ * A subscription context
+ */
+class SingleSourceSubscriptionCtx {
+
+public:
+    explicit SingleSourceSubscriptionCtx(const std::shared_ptr<SingleSourceSharedSubscription>& shared);
+
+    const std::shared_ptr<SingleSourceSharedSubscription> shared;
     std::unique_ptr<server::MonitorControlOp> subscriptionControl{};
     bool eventsEnabled = false;
     INST_COUNTER(SingleSourceSubscriptionCtx);
 
     ~SingleSourceSubscriptionCtx() {
         assert(!eventsEnabled);
-        // must db_cancel_event() before ~MonitorControlOp
-        cancel();
+        // no further updates posted to ~MonitorControlOp
+        if(subscriptionControl)
+            shared->stop(subscriptionControl.get());
     }
 };
 
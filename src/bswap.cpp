@@ -0,0 +1,193 @@
+/**
+ * Copyright - See the COPYRIGHT that is included with this distribution.
+ * pvxs is distributed subject to a Software License Agreement found
+ * in file LICENSE that is included with this distribution.
+ */
+
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP>=2)
+#  define PVXS_BSWAP_SSE2
+#  include <emmintrin.h>
+#endif
+
+// AVX2 kernels are compiled for a target which may not support AVX2,
+// so runtime detection is required.  Only with GCC (>= 4.9) and clang.
+#if defined(PVXS_BSWAP_SSE2) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) \
+    && (defined(__clang__) || __GNUC__>4 || (__GNUC__==4 && __GNUC_MINOR__>=9))
+#  define PVXS_BSWAP_AVX2
+#  include <immintrin.h>
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define PVXS_BSWAP_NEON
+#  include <arm_neon.h>
+#endif
+
+#include "pvaproto.h"
+
+namespace pvxs {
+namespace impl {
+
+namespace {
+
+/* Each kernel swaps as many elements as possible with vector instructions,
+ * then hands off the remainder to the scalar kernel.
+ * All loads and stores are unaligned.
+ */
+
+inline uint16_t bswap(uint16_t v) { return uint16_t((v<<8u) | (v>>8u)); }
+inline uint32_t bswap(uint32_t v) {
+    return (v<<24u) | ((v<<8u)&0x00ff0000u) | ((v>>8u)&0x0000ff00u) | (v>>24u);
+}
+inline uint64_t bswap(uint64_t v) {
+    return (uint64_t(bswap(uint32_t(v)))<<32u) | bswap(uint32_t(v>>32u));
+}
+
+template<typename T>
+void swapScalar(void* dest, const void* src, size_t nelem)
+{
+    auto D = static_cast<char*>(dest);
+    auto S = static_cast<const char*>(src);
+    for(size_t i=0u; i<nelem; i++) {
+        T temp;
+        memcpy(&temp, S + i*sizeof(T), sizeof(T));
+        temp = bswap(temp);
+        memcpy(D + i*sizeof(T), &temp, sizeof(T));
+    }
+}
+
+#ifdef PVXS_BSWAP_SSE2
+// SSE2 lacks a byte shuffle.  Swap bytes within 16-bit words by shifting,
+// then reorder words as needed.
+inline __m128i sse2Swap16(__m128i v) {
+    return _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+}
+
+template<typename T, __m128i (*fn)(__m128i)>
+void swapSSE2(void* dest, const void* src, size_t nelem)
+{
+    constexpr size_t perVec = sizeof(__m128i)/sizeof(T);
+    auto D = static_cast<char*>(dest);
+    auto S = static_cast<const char*>(src);
+    size_t i=0u;
+    for(; i+perVec<=nelem; i+=perVec) {
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(S + i*sizeof(T)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(D + i*sizeof(T)), (*fn)(v));
+    }
+    swapScalar<T>(D + i*sizeof(T), S + i*sizeof(T), nelem - i);
+}
+
+__m128i sse2Vec2(__m128i v) { return sse2Swap16(v); }
+__m128i sse2Vec4(__m128i v) {
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(2, 3, 0, 1));
+    return sse2Swap16(v);
+}
+__m128i sse2Vec8(__m128i v) {
+    v = _mm_shufflelo_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+    v = _mm_shufflehi_epi16(v, _MM_SHUFFLE(0, 1, 2, 3));
+    return sse2Swap16(v);
+}
+#endif // PVXS_BSWAP_SSE2
+
+#ifdef PVXS_BSWAP_AVX2
+template<typename T>
+__attribute__((target("avx2")))
+void swapAVX2(void* dest, const void* src, size_t nelem)
+{
+    // byte shuffle reversing each element.  Applies to each 128-bit lane
+    const __m256i mask = sizeof(T)==2 ?
+                _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                                 1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14)
+              : sizeof(T)==4 ?
+                _mm256_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+                                 3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)
+              : _mm256_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+                                 7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+    constexpr size_t perVec = sizeof(__m256i)/sizeof(T);
+    auto D = static_cast<char*>(dest);
+    auto S = static_cast<const char*>(src);
+    size_t i=0u;
+    for(; i+perVec<=nelem; i+=perVec) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(S + i*sizeof(T)));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(D + i*sizeof(T)), _mm256_shuffle_epi8(v, mask));
+    }
+    swapScalar<T>(D + i*sizeof(T), S + i*sizeof(T), nelem - i);
+}
+#endif // PVXS_BSWAP_AVX2
+
+#ifdef PVXS_BSWAP_NEON
+template<typename T, uint8x16_t (*fn)(uint8x16_t)>
+void swapNEON(void* dest, const void* src, size_t nelem)
+{
+    constexpr size_t perVec = 16u/sizeof(T);
+    auto D = static_cast<uint8_t*>(dest);
+    auto S = static_cast<const uint8_t*>(src);
+    size_t i=0u;
+    for(; i+perVec<=nelem; i+=perVec) {
+        vst1q_u8(D + i*sizeof(T), (*fn)(vld1q_u8(S + i*sizeof(T))));
+    }
+    swapScalar<T>(D + i*sizeof(T), S + i*sizeof(T), nelem - i);
+}
+
+uint8x16_t neonVec2(uint8x16_t v) { return vrev16q_u8(v); }
+uint8x16_t neonVec4(uint8x16_t v) { return vrev32q_u8(v); }
+uint8x16_t neonVec8(uint8x16_t v) { return vrev64q_u8(v); }
+#endif // PVXS_BSWAP_NEON
+
+std::vector<BSwapKernel> findKernels()
+{
+    std::vector<BSwapKernel> ret;
+    ret.push_back({"scalar", &swapScalar<uint16_t>, &swapScalar<uint32_t>, &swapScalar<uint64_t>});
+#ifdef PVXS_BSWAP_SSE2
+    ret.push_back({"sse2",
+                   &swapSSE2<uint16_t, &sse2Vec2>,
+                   &swapSSE2<uint32_t, &sse2Vec4>,
+                   &swapSSE2<uint64_t, &sse2Vec8>});
+#endif
+#ifdef PVXS_BSWAP_AVX2
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+        ret.push_back({"avx2", &swapAVX2<uint16_t>, &swapAVX2<uint32_t>, &swapAVX2<uint64_t>});
+#endif
+#ifdef PVXS_BSWAP_NEON
+    ret.push_back({"neon",
+                   &swapNEON<uint16_t, &neonVec2>,
+                   &swapNEON<uint32_t, &neonVec4>,
+                   &swapNEON<uint64_t, &neonVec8>});
+#endif
+    return ret;
+}
+
+// selected during static initialization
+const std::vector<BSwapKernel> kernels(findKernels());
+const BSwapKernel& best(kernels.back());
+
+} // namespace
+
+const std::vector<BSwapKernel>& bswap_kernels()
+{
+    return kernels;
+}
+
+void bswap_copy(void* dest, const void* src, size_t nelem, size_t esize)
+{
+    switch(esize) {
+    case 1: memcpy(dest, src, nelem); break;
+    case 2: (*best.swap2)(dest, src, nelem); break;
+    case 4: (*best.swap4)(dest, src, nelem); break;
+    case 8: (*best.swap8)(dest, src, nelem); break;
+    default: {
+        auto D = static_cast<char*>(dest);
+        auto S = static_cast<const char*>(src);
+        for(size_t i=0; i<nelem*esize; i+=esize) {
+            for(size_t n=0u; n<esize; n++) {
+                D[i + esize-1-n] = S[i + n];
+            }
+        }
+    }
+    }
+}
+
+}} // namespace pvxs::impl
@@ -5,6 +5,7 @@
  */
 
 #include <algorithm>
+#include <cmath>
 #include <set>
 #include <tuple>
 
@@ -50,6 +51,30 @@ constexpr size_t nBuckets = 30u;
  */
 constexpr size_t maxSearchPayload = 1400;
 
+/* Initial search of a large batch of newly created Channels is paced
+ * to avoid overflowing the receive buffers of servers (and of this client).
+ * At most searchWindow packets are sent per pacing interval,
+ * which follows the smoothed search response RTT.
+ * The window grows while names are found by their first search,
+ * and is halved when many are only found after a retry (presumed loss).
+ */
+constexpr size_t searchWindowMin = 4u;
+constexpr size_t searchWindowInit = 16u;
+constexpr size_t searchWindowMax = 256u;
+constexpr double searchPaceMin = 0.002; // 2 ms
+constexpr double searchPaceMax = 0.1; // 100 ms
+// While an initial search backlog exists, retries are deferred by at most this
+// many consecutive check ticks.  The next tick sends all of its retries.
+constexpr size_t searchDeferMax = 4u;
+
+// Responses to all search packets sent in one pacing interval (initial and retry)
+// can be matched to their send time.
+static_assert(std::tuple_size<decltype(ContextImpl::searchSent)>::value >= 2u*searchWindowMax,
+              "searchSent too small for searchWindowMax");
+
+// limit on the number of search responders for which we track RTT
+constexpr size_t searchPeerLimit{1024};
+
 /* Interval between checks for Channels which are no longer used by any operation.
  * Channels will be discarded if found to be unused by two consecutive checks.
  */
@@ -67,8 +92,9 @@ constexpr timeval beaconCleanInterval{180, 0};
 // special interval to attempt to reconnect to disconnected name servers
 constexpr timeval tcpNSCheckInterval{10, 0};
 
-// searchSequenceID in CMD_SEARCH is redundant.
-// So we use a static value and instead rely on IDs for individual PVs
+// searchSequenceID in CMD_SEARCH is redundant for finding PVs,
+// which rely on IDs for individual PVs.  Discovery pings use a static value.
+// Other search requests use a counter, which is only used to measure RTT.
 constexpr uint32_t search_seq{0x66696e64}; // "find"
 } // namespace
 
@@ -138,6 +164,7 @@ void Channel::createOperations()
                                            std::forward_as_tuple(ioid),
                                            std::forward_as_tuple(sid, ioid, op));
         opByIOID[ioid] = &pair.first->second;
+        conn->addOp(ioid, op->rxInfo());
 
         op->ioid = ioid;
 
@@ -172,16 +199,16 @@ void Channel::disconnect(const std::shared_ptr<Channel>& self)
         break;
     }
 
-    if((state==Creating || state==Active) && current && current->connection()) {
+    if((state==Creating || state==Active) && current && current->ready) {
         {
-            (void)evbuffer_drain(current->txBody.get(), evbuffer_get_length(current->txBody.get()));
+            (void)evbuffer_drain(current->txMsg.get(), evbuffer_get_length(current->txMsg.get()));
 
-            EvOutBuf R(current->sendBE, current->txBody.get());
+            EvOutBuf R(current->txBE, current->txMsg.get());
 
             to_wire(R, sid);
             to_wire(R, cid);
         }
-        statTx += current->enqueueTxBody(CMD_DESTROY_CHANNEL);
+        statTx += current->enqueueTx(CMD_DESTROY_CHANNEL);
     }
 
     state = Channel::Searching;
@@ -197,7 +224,7 @@ void Channel::disconnect(const std::shared_ptr<Channel>& self)
     auto ops(std::move(opByIOID));
     for(auto& pair : ops) {
         auto op = pair.second->handle.lock();
-        current->opByIOID.erase(pair.first);
+        current->forgetOp(pair.first);
         if(op)
             op->disconnected(op);
     }
@@ -317,6 +344,11 @@ OperationBase::OperationBase(operation_t op, const evbase& loop)
 
 OperationBase::~OperationBase() {}
 
+RxInfo OperationBase::rxInfo() const
+{
+    return RxInfo(op);
+}
+
 const std::string& OperationBase::name()
 {
     return chan->name;
@@ -473,12 +505,17 @@ Report Context::report(bool zero) const
             ret.connections.emplace_back();
             auto& sconn = ret.connections.back();
             sconn.peer = conn->peerName;
-            sconn.tx = conn->statTx;
-            sconn.rx = conn->statRx;
+            sconn.worker = conn->worker;
 
-            if(zero) {
-                conn->statTx = conn->statRx = 0u;
-            }
+            // socket statistics are kept by the worker which owns the Connection
+            conn->loop.call([&conn, &sconn, zero](){
+                sconn.tx = conn->statTx;
+                sconn.rx = conn->statRx;
+
+                if(zero) {
+                    conn->statTx = conn->statRx = 0u;
+                }
+            });
 
             // omit stats for transitory conn->creatingByCID
 
@@ -499,6 +536,23 @@ Report Context::report(bool zero) const
             }
         }
 
+        for(auto& pair : pvt->impl->searchPeers) {
+            ret.searchPeers.emplace_back();
+            auto& speer = ret.searchPeers.back();
+            speer.peer = pair.first.tostring();
+            speer.rtt = pair.second.srtt;
+            speer.rttVar = pair.second.rttvar;
+            speer.nFirst = pair.second.nFirst;
+            speer.nRetry = pair.second.nRetry;
+
+            if(zero) {
+                pair.second.nFirst = pair.second.nRetry = 0u;
+            }
+        }
+
+        ret.nSearchTx += pvt->impl->statSearchTx;
+        if(zero)
+            pvt->impl->statSearchTx = 0u;
     });
 
     return ret;
@@ -543,6 +597,7 @@ ContextImpl::ContextImpl(const Config& conf, const evbase& tcp_loop)
                event_new(tcp_loop.base, -1, EV_TIMEOUT|EV_PERSIST, &ContextImpl::onNSCheckS, this))
 {
     searchBuckets.resize(nBuckets);
+    searchWindow = searchWindowInit;
 
     std::set<SockAddr, SockAddrOnlyLess> bcasts;
     for(auto& addr : searchTx4.broadcasts()) {
@@ -664,6 +719,25 @@ void ContextImpl::startNS()
     });
 }
 
+size_t ContextImpl::pickWorker()
+{
+    if(tcp_workers.size()<=1u)
+        return 0u;
+
+    std::vector<size_t> load(tcp_workers.size(), 0u);
+
+    for(auto it(connByAddr.begin()), end(connByAddr.end()); it!=end;) {
+        if(auto conn = it->second.lock()) {
+            load[conn->worker]++;
+            ++it;
+        } else {
+            it = connByAddr.erase(it);
+        }
+    }
+
+    return std::min_element(load.begin(), load.end()) - load.begin();
+}
+
 void ContextImpl::close()
 {
     log_debug_printf(setup, "context %p close\n", this);
@@ -675,6 +749,7 @@ void ContextImpl::close()
         state = Stopped;
 
         (void)event_del(searchTimer.get());
+        (void)event_del(initialSearcher.get());
         (void)event_del(searchRx4.get());
         (void)event_del(searchRx6.get());
         (void)event_del(beaconCleaner.get());
@@ -689,7 +764,11 @@ void ContextImpl::close()
             if(!conn)
                 continue;
 
-            conn->cleanup();
+            conn->loop.call([&conn]() {
+                conn->cleanup();
+            });
+            // complete now, instead of waiting for cleanup() to queue
+            conn->detach();
         }
 
         conns.clear();
@@ -701,6 +780,10 @@ void ContextImpl::close()
         // we are orphaning some Operations
     });
 
+    // complete release of Connections
+    for(auto& worker : tcp_workers) {
+        worker.sync();
+    }
     tcp_loop.sync();
 
     // ensure any in-progress callbacks have completed
@@ -832,7 +915,8 @@ void procSearchReply(ContextImpl& self, const SockAddr& src, uint8_t peerVersion
 
     _from_wire<12>(M, &guid[0], false, __FILE__, __LINE__);
     // searchSequenceID
-    // we don't use this for normal search and instead rely on ID for individual PVs
+    // we don't use this to find PVs and instead rely on ID for individual PVs.
+    // Only to measure RTT.
     from_wire(M, seq);
 
     from_wire(M, serv);
@@ -876,6 +960,21 @@ void procSearchReply(ContextImpl& self, const SockAddr& src, uint8_t peerVersion
     if(!found || proto!="tcp")
         return;
 
+    auto peer = self.searchPeer(src);
+    {
+        const auto& sent = self.searchSent[seq % self.searchSent.size()];
+        if(M.good() && seq!=search_seq && sent.first==seq && sent.second) {
+            double rtt = (epicsMonotonicGet() - sent.second)*1e-9;
+            self.searchRTT.sample(rtt);
+            if(peer)
+                peer->sample(rtt);
+        }
+    }
+
+    // all names in one reply are claimed by the same server.
+    // Create their channels together.
+    std::shared_ptr<Connection> conn;
+
     for(auto n : range(nSearch)) {
         (void)n;
 
@@ -898,16 +997,30 @@ void procSearchReply(ContextImpl& self, const SockAddr& src, uint8_t peerVersion
         log_debug_printf(io, "Search reply for %s\n", chan->name.c_str());
 
         if(chan->state==Channel::Searching) {
+            // a name found only after a retry is presumed to indicate loss
+            if(chan->nSearchSent>1u) {
+                self.winRetry++;
+                self.searchRTT.nRetry++;
+                if(peer)
+                    peer->nRetry++;
+            } else {
+                self.winFirst++;
+                self.searchRTT.nFirst++;
+                if(peer)
+                    peer->nFirst++;
+            }
+            chan->nSearchSent = 0u;
+
             chan->guid = guid;
             chan->replyAddr = serv;
 
-            chan->conn = Connection::build(self.shared_from_this(), serv);
+            if(!conn)
+                conn = Connection::build(self.shared_from_this(), serv);
+            chan->conn = conn;
 
             chan->conn->pending[chan->cid] = chan;
             chan->state = Channel::Connecting;
 
-            chan->conn->createChannels();
-
         } else if(chan->guid!=guid) {
             log_err_printf(duppv, "Duplicate PV name %s from %s and %s\n",
                            chan->name.c_str(),
@@ -916,6 +1029,8 @@ void procSearchReply(ContextImpl& self, const SockAddr& src, uint8_t peerVersion
         }
     }
 
+    if(conn)
+        conn->createChannels();
 }
 
 bool ContextImpl::onSearch(evutil_socket_t fd)
@@ -979,15 +1094,25 @@ bool ContextImpl::onSearch(evutil_socket_t fd)
 
 void Connection::handle_SEARCH_RESPONSE()
 {
-    EvInBuf M(peerBE, segBuf.get(), 16);
-
-    procSearchReply(*context, peerAddr, peerVersion, M, true);
-
-    if(!M.good()) {
-        log_crit_printf(io, "%s:%d Server %s sends invalid SEARCH_RESPONSE.  Disconnecting...\n",
-                        M.file(), M.line(), peerName.c_str());
-        bev.reset();
-    }
+    // search state is kept by context->tcp_loop
+    std::vector<uint8_t> body(evbuffer_get_length(segBuf.get()));
+    (void)evbuffer_remove(segBuf.get(), body.data(), body.size());
+
+    auto self(shared_from_this());
+    auto be = peerBE;
+    auto version = peerVersion;
+    // std::bind for lack of c++14 generalized capture
+    onContext(std::bind([this, self, be, version](std::vector<uint8_t>& body) {
+        FixedBuf M(be, body);
+
+        procSearchReply(*context, peerAddr, version, M, true);
+
+        if(!M.good()) {
+            log_crit_printf(io, "%s:%d Server %s sends invalid SEARCH_RESPONSE.  Disconnecting...\n",
+                            M.file(), M.line(), peerName.c_str());
+            forceDisconnect();
+        }
+    }, std::move(body)));
 }
 
 void ContextImpl::onSearchS(evutil_socket_t fd, short evt, void *raw)
@@ -1008,6 +1133,28 @@ void ContextImpl::onSearchS(evutil_socket_t fd, short evt, void *raw)
     }
 }
 
+static
+void logSearchTx(const sendmmsgx::Dest& D, const uint8_t* msg, size_t msglen, bool ucast)
+{
+    if(D.ntx<0) {
+        auto lvl = Level::Warn;
+        if(D.err==EINTR || D.err==EPERM)
+            lvl = Level::Debug;
+        log_printf(io, lvl, "Search tx %s error (%d) %s\n",
+                   D.addr->tostring().c_str(), D.err, evutil_socket_error_to_string(D.err));
+
+    } else if(unsigned(D.ntx)<msglen) {
+        log_warn_printf(io, "Search truncated %u < %u",
+                   unsigned(D.ntx), unsigned(msglen));
+
+    } else {
+        log_hex_printf(io, Level::Debug, (const char*)msg, msglen,
+                       "Search to %s %s\n",
+                       D.addr->tostring().c_str(),
+                       ucast ? "ucast" : "bcast");
+    }
+}
+
 void ContextImpl::tickSearch(SearchKind kind, bool poked)
 {
     // If kind == SearchKind::discover, then this is a discovery ping.
@@ -1016,7 +1163,12 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
     //
     // If kind == SearchKind::initial we are sending the first search request
     // for the channels in initalSearchBucket, and not resending requests for
-    // channels in the searchBuckets.
+    // channels in the searchBuckets.  At most searchWindow packets are sent,
+    // with any remaining channels left for the next initialSearcher tick.
+    //
+    // While an initial search backlog exists, a check tick also sends at most
+    // searchWindow packets, with any remaining channels retried on the next tick.
+    // After searchDeferMax consecutive deferrals, a check tick sends all of its retries.
 
     auto idx = currentBucket;
     if(kind == SearchKind::check)
@@ -1025,21 +1177,48 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
     log_debug_printf(io, "Search tick %zu\n", idx);
 
     decltype (searchBuckets)::value_type bucket;
+    size_t npkt = 0u;
     if (kind == SearchKind::initial) {
+        adaptSearchWindow();
         initialSearchBucket.swap(bucket);
+
     } else if(kind == SearchKind::check) {
         searchBuckets[idx].swap(bucket);
     }
+    const bool pacedRetry = kind == SearchKind::check && !initialSearchBucket.empty()
+            && searchDeferred < searchDeferMax;
+    bool deferred = false;
 
     while(!bucket.empty() || kind == SearchKind::discover) {
         // when 'discover' we only loop once
 
+        if(kind == SearchKind::initial && npkt >= searchWindow) {
+            // initial search backlog.  Keep ordering.
+            initialSearchBucket.splice(initialSearchBucket.begin(), bucket);
+            break;
+
+        } else if(pacedRetry && npkt >= searchWindow) {
+            // share bandwidth with the initial search backlog.  Retry the remainder on the next tick.
+            auto& nextBucket = searchBuckets[currentBucket];
+            nextBucket.splice(nextBucket.begin(), bucket);
+            log_debug_printf(io, "Search tick %zu partly deferred for initial search\n", idx);
+            deferred = true;
+            break;
+        }
+        npkt++;
+
         searchMsg.resize(0x10000);
         FixedBuf M(true, searchMsg.data(), searchMsg.size());
         M.skip(8, __FILE__, __LINE__); // fill in header after body length known
 
         // searchSequenceID
-        to_wire(M, search_seq);
+        uint32_t seq = search_seq;
+        if(kind != SearchKind::discover) {
+            do {
+                seq = searchSeq++;
+            } while(seq==search_seq);
+        }
+        to_wire(M, seq);
 
         // flags and reserved.
         // initially flags[7] is cleared (bcast)
@@ -1107,6 +1286,7 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
             }
 
             count++;
+            chan->nSearchSent++;
 
             size_t ninc = 0u;
             if(kind==SearchKind::check && !poked)
@@ -1144,38 +1324,49 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
             FixedBuf H(true, searchMsg.data(), 8);
             to_wire(H, Header{CMD_SEARCH, 0, uint32_t(consumed-8u)});
         }
-        for(auto& pair : searchDest) {
-            auto& dest = pair.first.addr.family()==AF_INET ? searchTx4 : searchTx6;
-
-            if(pair.second) {
+        searchSent[seq % searchSent.size()] = std::make_pair(seq, epicsUInt64(epicsMonotonicGet()));
+        // Destinations sharing a socket and Unicast flag are sent together.
+        // mcast destinations need per-destination socket options, so are sent alone.
+        for(auto ucast : {true, false}) {
+            if(ucast) {
                 *pflags |= pva_search_flags::Unicast;
 
             } else {
                 *pflags &= ~pva_search_flags::Unicast;
-
-                dest.mcast_prep_sendto(pair.first);
             }
 
-            int ntx = sendto(dest.sock, (char*)searchMsg.data(), consumed, 0,
-                             &pair.first.addr->sa, pair.first.addr.size());
+            for(auto af : {AF_INET, AF_INET6}) {
+                auto& tx = af==AF_INET ? searchTx4 : searchTx6;
+                searchBatch.clear();
 
-            if(ntx<0) {
-                int err = evutil_socket_geterror(dest.sock);
-                auto lvl = Level::Warn;
-                if(err==EINTR || err==EPERM)
-                    lvl = Level::Debug;
-                log_printf(io, lvl, "Search tx %s error (%d) %s\n",
-                           pair.first.addr.tostring().c_str(), err, evutil_socket_error_to_string(err));
+                for(auto& pair : searchDest) {
+                    if(pair.second!=ucast || pair.first.addr.family()!=af) {
+                        continue;
 
-            } else if(unsigned(ntx)<consumed) {
-                log_warn_printf(io, "Search truncated %u < %u",
-                           unsigned(ntx), unsigned(consumed));
+                    } else if(pair.first.addr.isMCast()) {
+                        tx.mcast_prep_sendto(pair.first);
 
-            } else {
-                log_hex_printf(io, Level::Debug, (char*)searchMsg.data(), consumed,
-                               "Search to %s %s\n",
-                               std::string(SB()<<pair.first).c_str(),
-                               pair.second ? "ucast" : "bcast");
+                        sendmmsgx::Dest D{&pair.first.addr};
+                        sendmmsgx{tx.sock, searchMsg.data(), consumed, &D, 1u}.call();
+                        logSearchTx(D, searchMsg.data(), consumed, ucast);
+                        if(D.ntx>=0)
+                            statSearchTx++;
+
+                    } else {
+                        searchBatch.push_back(sendmmsgx::Dest{&pair.first.addr});
+                    }
+                }
+
+                if(searchBatch.empty())
+                    continue;
+
+                sendmmsgx{tx.sock, searchMsg.data(), consumed, searchBatch.data(), searchBatch.size()}.call();
+
+                for(const auto& D : searchBatch) {
+                    logSearchTx(D, searchMsg.data(), consumed, ucast);
+                    if(D.ntx>=0)
+                        statSearchTx++;
+                }
             }
         }
         *pflags |= 0x80; // TCP search is always "unicast"
@@ -1186,23 +1377,75 @@ void ContextImpl::tickSearch(SearchKind kind, bool poked)
         for(auto& pair : nameServers) {
             auto& serv = pair.second;
 
-            if(!serv->ready || !serv->connection())
+            if(!serv->ready)
                 continue;
 
-            auto tx = bufferevent_get_output(serv->connection());
-
-            // arbitrarily skip searching if TX buffer is too full
-            // TODO: configure limit?
-            if(evbuffer_get_length(tx) > 64*1024u)
-                continue;
-
-            (void)evbuffer_add(tx, (char*)searchMsg.data(), consumed);
-            // fail silently, will retry
+            serv->sendSearch(searchMsg.data(), consumed);
         }
 
         if(kind == SearchKind::discover)
             break;
     }
+
+    if(kind == SearchKind::check)
+        searchDeferred = deferred ? searchDeferred+1u : 0u;
+
+    if(kind == SearchKind::initial && !initialSearchBucket.empty()) {
+        auto pace(searchPace());
+        log_debug_printf(io, "Initial search paced, window %zu, %ld us\n",
+                         searchWindow, long(pace.tv_usec));
+        initialSearchScheduled = true;
+        if(event_add(initialSearcher.get(), &pace))
+            log_err_printf(setup, "Error re-enabling initial search timer\n%s", "");
+    }
+}
+
+ContextImpl::SearchRTT* ContextImpl::searchPeer(const SockAddr& peer)
+{
+    auto it = searchPeers.find(peer);
+    if(it==searchPeers.end()) {
+        if(searchPeers.size() >= searchPeerLimit)
+            return nullptr;
+        it = searchPeers.emplace(peer, SearchRTT()).first;
+    }
+    return &it->second;
+}
+
+void ContextImpl::SearchRTT::sample(double rtt)
+{
+    // as with TCP RTO estimation (RFC 6298)
+    if(!nSample) {
+        srtt = rtt;
+        rttvar = rtt/2.0;
+    } else {
+        rttvar = 0.75*rttvar + 0.25*std::fabs(srtt - rtt);
+        srtt = 0.875*srtt + 0.125*rtt;
+    }
+    nSample++;
+}
+
+void ContextImpl::adaptSearchWindow()
+{
+    auto nFound = winFirst + winRetry;
+    if(nFound >= 8u && winRetry*8u > nFound) {
+        // more than 1/8th needed a retry
+        searchWindow = std::max(searchWindowMin, searchWindow/2u);
+
+    } else if(winFirst) {
+        searchWindow = std::min(searchWindowMax, searchWindow + std::max(size_t(1u), searchWindow/4u));
+
+    } else {
+        return; // no new information
+    }
+    winFirst = winRetry = 0u;
+}
+
+timeval ContextImpl::searchPace() const
+{
+    double pace = initialSearchDelay.tv_usec*1e-6;
+    if(searchRTT.nSample)
+        pace = std::max(searchPaceMin, std::min(searchPaceMax, searchRTT.srtt + 4.0*searchRTT.rttvar));
+    return totv(pace);
 }
 
 void ContextImpl::tickSearchS(evutil_socket_t fd, short evt, void *raw)
@@ -1283,7 +1526,7 @@ void ContextImpl::tickBeaconCleanS(evutil_socket_t fd, short evt, void *raw)
 void ContextImpl::onNSCheck()
 {
     for(auto& ns : nameServers) {
-        if(ns.second && ns.second->state != ConnBase::Disconnected) // hold-off, connecting, or connected
+        if(ns.second && !ns.second->closed) // hold-off, connecting, or connected
             continue;
 
         ns.second = Connection::build(shared_from_this(), ns.first);
@@ -1350,7 +1593,21 @@ void ContextImpl::cacheCleanS(evutil_socket_t fd, short evt, void *raw)
 Context::Pvt::Pvt(const Config& conf)
     :loop("PVXCTCP", epicsThreadPriorityCAServerLow)
     ,impl(std::make_shared<ContextImpl>(conf, loop.internal()))
-{}
+{
+    auto nworkers = impl->effective.tcpWorkers;
+
+    if(nworkers<=1u) {
+        impl->tcp_workers.push_back(impl->tcp_loop);
+
+    } else {
+        workers.reserve(nworkers);
+        impl->tcp_workers.reserve(nworkers);
+        for(auto i : range(nworkers)) {
+            workers.emplace_back(SB()<<"PVXCTCP-"<<i, epicsThreadPriorityCAServerLow);
+            impl->tcp_workers.push_back(workers.back().internal());
+        }
+    }
+}
 
 Context::Pvt::~Pvt()
 {
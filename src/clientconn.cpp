@@ -18,30 +18,29 @@ DEFINE_LOGGER(remote, "pvxs.remote.log");
 
 Connection::Connection(const std::shared_ptr<ContextImpl>& context,
                        const SockAddr& peerAddr,
-                       bool reconn)
+                       size_t worker)
     :ConnBase (true, context->effective.sendBE(),
                nullptr,
                peerAddr)
     ,context(context)
+    ,loop(context->tcp_workers.at(worker))
+    ,worker(worker)
+    ,ioWorker(loop.base!=context->tcp_loop.base)
     ,echoTimer(__FILE__, __LINE__,
-               event_new(context->tcp_loop.base, -1, EV_TIMEOUT|EV_PERSIST, &tickEchoS, this))
+               event_new(loop.base, -1, EV_TIMEOUT|EV_PERSIST, &tickEchoS, this))
+    ,txMsg(__FILE__, __LINE__, evbuffer_new())
+    ,txBE(sendBE)
 {
-    if(reconn) {
-        log_debug_printf(io, "start holdoff timer for %s\n", peerName.c_str());
-
-        constexpr timeval holdoff{2, 0};
-        if(event_add(echoTimer.get(), &holdoff))
-            log_err_printf(io, "Server %s error starting echoTimer as holdoff\n", peerName.c_str());
-
-    } else {
-        startConnecting();
-    }
+    txSegment = context->effective.tcpSegmentSize;
+    rxReserveMax = context->effective.tcpReserveMax;
 }
 
 Connection::~Connection()
 {
     log_debug_printf(io, "Cleaning connection to %s\n", peerName.c_str());
-    cleanup();
+    // on loop, or after it has stopped.  cf. build()
+    // release before our ref. to loop
+    bev.reset();
 }
 
 std::shared_ptr<Connection> Connection::build(const std::shared_ptr<ContextImpl>& context,
@@ -53,24 +52,58 @@ std::shared_ptr<Connection> Connection::build(const std::shared_ptr<ContextImpl>
     std::shared_ptr<Connection> ret;
     auto it = context->connByAddr.find(serv);
     if(it==context->connByAddr.end() || !(ret = it->second.lock())) {
-        context->connByAddr[serv] = ret = std::make_shared<Connection>(context, serv, reconn);
+        // socket and timers are released by the worker which uses them
+        ret.reset(new Connection(context, serv, context->pickWorker()), [](Connection* conn) {
+            auto loop(conn->loop);
+            if(!conn->ioWorker || !loop.tryDispatch([conn]() { delete conn; }))
+                delete conn;
+        });
+        context->connByAddr[serv] = ret;
+
+        ret->start(reconn);
+        if(ret->closed) // only possible when !ioWorker
+            throw std::runtime_error(SB()<<"Unable to connect to "<<serv);
     }
     return ret;
 }
 
+void Connection::start(bool reconn)
+{
+    auto self(shared_from_this());
+    onLoop([self, reconn]() {
+        if(reconn) {
+            log_debug_printf(io, "start holdoff timer for %s\n", self->peerName.c_str());
+
+            constexpr timeval holdoff{2, 0};
+            if(event_add(self->echoTimer.get(), &holdoff))
+                log_err_printf(io, "Server %s error starting echoTimer as holdoff\n", self->peerName.c_str());
+
+        } else {
+            try {
+                self->startConnecting();
+            }catch(std::exception& e){
+                log_err_printf(io, "Server %s %s\n", self->peerName.c_str(), e.what());
+                self->cleanup();
+            }
+        }
+    });
+}
+
 void Connection::startConnecting()
 {
     assert(!this->bev);
 
-    auto bev(bufferevent_socket_new(context->tcp_loop.base, -1, BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS));
+    auto bev(bufferevent_socket_new(loop.base, -1, BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS));
 
     bufferevent_setcb(bev, &bevReadS, nullptr, &bevEventS, this);
 
     timeval tmo(totv(context->effective.tcpTimeout));
     bufferevent_set_timeouts(bev, &tmo, &tmo);
 
-    if(bufferevent_socket_connect(bev, const_cast<sockaddr*>(&peerAddr->sa), peerAddr.size()))
+    if(bufferevent_socket_connect(bev, const_cast<sockaddr*>(&peerAddr->sa), peerAddr.size())) {
+        bufferevent_free(bev);
         throw std::runtime_error("Unable to begin connecting");
+    }
     {
         auto fd(bufferevent_getfd(bev));
         int opt = 1;
@@ -90,48 +123,164 @@ void Connection::createChannels()
     if(!ready)
         return; // defer until CONNECTION_VALIDATED
 
-    (void)evbuffer_drain(txBody.get(), evbuffer_get_length(txBody.get()));
+    (void)evbuffer_drain(txMsg.get(), evbuffer_get_length(txMsg.get()));
 
     auto todo = std::move(pending);
 
-    for(auto& pair : todo) {
-        auto chan = pair.second.lock();
-        if(!chan || chan->state!=Channel::Connecting)
-            continue;
+    // up to createBatch channels per CREATE_CHANNEL message
+    const size_t limit = context->effective.createBatch;
+    std::vector<std::shared_ptr<Channel>> batch;
+    batch.reserve(std::min(limit, todo.size()));
+
+    auto it = todo.begin();
+    while(it!=todo.end()) {
+        batch.clear();
+        for(; it!=todo.end() && batch.size()<limit; ++it) {
+            auto chan = it->second.lock();
+            if(chan && chan->state==Channel::Connecting)
+                batch.push_back(std::move(chan));
+        }
+        if(batch.empty())
+            break;
 
         {
-            (void)evbuffer_drain(txBody.get(), evbuffer_get_length(txBody.get()));
+            EvOutBuf R(txBE, txMsg.get());
+
+            to_wire(R, uint16_t(batch.size()));
+            for(auto& chan : batch) {
+                to_wire(R, chan->cid);
+                to_wire(R, chan->name);
+            }
+        }
+        // divide message size evenly between channels
+        auto total = enqueueTx(CMD_CREATE_CHANNEL);
+        auto share = total/batch.size();
 
-            EvOutBuf R(sendBE, txBody.get());
+        for(auto& chan : batch) {
+            chan->statTx += share;
 
-            to_wire(R, uint16_t(1u));
-            to_wire(R, chan->cid);
-            to_wire(R, chan->name);
+            creatingByCID[chan->cid] = chan;
+            chan->state = Channel::Creating;
+
+            log_debug_printf(io, "Server %s creating channel '%s' (%u)\n", peerName.c_str(),
+                             chan->name.c_str(), unsigned(chan->cid));
         }
-        chan->statTx += enqueueTxBody(CMD_CREATE_CHANNEL);
+        log_debug_printf(io, "Server %s create %zu channels\n", peerName.c_str(), batch.size());
+    }
+}
 
-        creatingByCID[chan->cid] = chan;
-        chan->state = Channel::Creating;
+size_t Connection::enqueueTx(pva_app_msg_t cmd)
+{
+    auto blen = evbuffer_get_length(txMsg.get());
 
-        log_debug_printf(io, "Server %s creating channel '%s' (%u)\n", peerName.c_str(),
-                         chan->name.c_str(), unsigned(chan->cid));
+    if(!ioWorker) {
+        if(!bev) {
+            (void)evbuffer_drain(txMsg.get(), blen);
+            return 0u;
+        }
+        (void)evbuffer_drain(txBody.get(), evbuffer_get_length(txBody.get()));
+        auto err = evbuffer_add_buffer(txBody.get(), txMsg.get());
+        assert(!err); // could only fail if frozen/pinned, which is not the case
+        (void)err;
+        return enqueueTxBody(cmd);
     }
+
+    evbuf body(__FILE__, __LINE__, evbuffer_new());
+    if(evbuffer_add_buffer(body.get(), txMsg.get()))
+        throw BAD_ALLOC();
+
+    auto self(shared_from_this());
+    // std::bind for lack of c++14 generalized capture
+    onLoop(std::bind([self, cmd](evbuf& body) {
+        if(!self->bev)
+            return;
+        (void)evbuffer_drain(self->txBody.get(), evbuffer_get_length(self->txBody.get()));
+        (void)evbuffer_add_buffer(self->txBody.get(), body.get());
+        self->enqueueTxBody(cmd);
+    }, std::move(body)));
+
+    // as will be counted by enqueueTxBody()
+    size_t nseg = 1u;
+    if(txSegment && blen > txSegment)
+        nseg = (blen + txSegment - 1u)/txSegment;
+    return 8u*nseg + blen;
 }
 
-void Connection::sendDestroyRequest(uint32_t sid, uint32_t ioid)
+void Connection::sendRaw(const uint8_t* msg, size_t len)
 {
     if(!bev)
         return;
+
+    auto tx = bufferevent_get_output(bev.get());
+
+    // arbitrarily skip searching if TX buffer is too full
+    // TODO: configure limit?
+    if(evbuffer_get_length(tx) > 64*1024u)
+        return;
+
+    (void)evbuffer_add(tx, msg, len);
+    // fail silently, will retry
+}
+
+void Connection::sendSearch(const uint8_t* msg, size_t len)
+{
+    if(!ioWorker) {
+        sendRaw(msg, len);
+        return;
+    }
+
+    // caller re-uses msg
+    std::vector<uint8_t> copy(msg, msg+len);
+    auto self(shared_from_this());
+    onLoop(std::bind([self](std::vector<uint8_t>& copy) {
+        self->sendRaw(copy.data(), copy.size());
+    }, std::move(copy)));
+}
+
+void Connection::sendDestroyRequest(uint32_t sid, uint32_t ioid)
+{
+    if(!ready)
+        return;
     {
-        (void)evbuffer_drain(txBody.get(), evbuffer_get_length(txBody.get()));
+        (void)evbuffer_drain(txMsg.get(), evbuffer_get_length(txMsg.get()));
 
-        EvOutBuf R(sendBE, txBody.get());
+        EvOutBuf R(txBE, txMsg.get());
 
         to_wire(R, sid);
         to_wire(R, ioid);
     }
-    enqueueTxBody(CMD_DESTROY_REQUEST);
+    enqueueTx(CMD_DESTROY_REQUEST);
+
+}
+
+void Connection::addOp(uint32_t ioid, RxInfo&& info)
+{
+    auto self(shared_from_this());
+    onLoop(std::bind([self, ioid](RxInfo& info) {
+        self->rxByIOID.erase(ioid);
+        self->rxByIOID.emplace(ioid, std::move(info));
+    }, std::move(info)));
+}
+
+void Connection::forgetOp(uint32_t ioid)
+{
+    opByIOID.erase(ioid);
 
+    auto self(shared_from_this());
+    onLoop([self, ioid]() {
+        self->rxByIOID.erase(ioid);
+    });
+}
+
+void Connection::forceDisconnect()
+{
+    auto self(shared_from_this());
+    onLoop([self]() {
+        if(self->bev) {
+            self->bev.reset();
+            self->cleanup();
+        }
+    });
 }
 
 void Connection::bevEvent(short events)
@@ -163,16 +312,31 @@ std::shared_ptr<ConnBase> Connection::self_from_this()
 
 void Connection::cleanup()
 {
-    ready = false;
-
-    context->connByAddr.erase(peerAddr);
-
     if(bev)
         bev.reset();
 
     if(event_del(echoTimer.get()))
         log_err_printf(io, "Server %s error stopping echoTimer\n", peerName.c_str());
 
+    rxByIOID.clear();
+    rxPartial.reset();
+    rxPartialSkip = false;
+
+    auto self(shared_from_this());
+    onContext([self]() {
+        self->detach();
+    });
+}
+
+void Connection::detach()
+{
+    if(closed)
+        return;
+    closed = true;
+    ready = false;
+
+    context->connByAddr.erase(peerAddr);
+
     // return Channels to Searching state
     std::set<std::shared_ptr<Channel>> todo;
     for(auto& pair : pending) {
@@ -312,14 +476,22 @@ void Connection::handle_CONNECTION_VALIDATED()
                          sts.msg.empty() ? "" : " ", sts.msg.c_str());
     }
 
-    ready = true;
+    auto self(shared_from_this());
+    auto be = sendBE;
+    onContext([this, self, be]() {
+        if(closed)
+            return;
 
-    createChannels();
+        txBE = be;
+        ready = true;
 
-    if(nameserver) {
-        log_info_printf(io, "(re)connected to nameserver %s\n", peerName.c_str());
-        context->poke();
-    }
+        createChannels();
+
+        if(nameserver) {
+            log_info_printf(io, "(re)connected to nameserver %s\n", peerName.c_str());
+            context->poke();
+        }
+    });
 }
 
 void Connection::handle_CREATE_CHANNEL()
@@ -342,60 +514,63 @@ void Connection::handle_CREATE_CHANNEL()
         return;
     }
 
-    std::shared_ptr<Channel> chan;
-    {
-        auto it = creatingByCID.find(cid);
-        if(it==creatingByCID.end() || !(chan = it->second.lock())) {
+    auto self(shared_from_this());
+    onContext([this, self, rxlen, cid, sid, sts]() {
+        std::shared_ptr<Channel> chan;
+        {
+            auto it = creatingByCID.find(cid);
+            if(it==creatingByCID.end() || !(chan = it->second.lock())) {
 
-            if(it!=creatingByCID.end())
-                creatingByCID.erase(it);
+                if(it!=creatingByCID.end())
+                    creatingByCID.erase(it);
 
-            if(sts.isSuccess()) {
-                // we now have a channel which is no longer interesting.
-                log_debug_printf(io, "Server %s disposing of newly stale channel\n", peerName.c_str());
+                if(sts.isSuccess()) {
+                    // we now have a channel which is no longer interesting.
+                    log_debug_printf(io, "Server %s disposing of newly stale channel\n", peerName.c_str());
 
-                {
-                    (void)evbuffer_drain(txBody.get(), evbuffer_get_length(txBody.get()));
+                    {
+                        (void)evbuffer_drain(txMsg.get(), evbuffer_get_length(txMsg.get()));
 
-                    EvOutBuf R(sendBE, txBody.get());
-                    to_wire(R, sid);
-                    to_wire(R, cid);
+                        EvOutBuf R(txBE, txMsg.get());
+                        to_wire(R, sid);
+                        to_wire(R, cid);
+                    }
+                    enqueueTx(CMD_DESTROY_CHANNEL);
                 }
-                enqueueTxBody(CMD_DESTROY_CHANNEL);
+                return;
             }
-            return;
+            creatingByCID.erase(it);
         }
-        creatingByCID.erase(it);
-    }
-    chan->statRx += rxlen;
+        chan->statRx += rxlen;
 
-    if(!sts.isSuccess()) {
-        // server refuses to create a channel, but presumably responded positively to search
+        if(!sts.isSuccess()) {
+            // server refuses to create a channel, but presumably responded positively to search
 
-        chan->state = Channel::Searching;
-        context->searchBuckets[context->currentBucket].push_back(chan);
+            chan->state = Channel::Searching;
+            context->searchBuckets[context->currentBucket].push_back(chan);
 
-        log_warn_printf(io, "Server %s refuses channel to '%s' : %s\n", peerName.c_str(),
-                        chan->name.c_str(), sts.msg.c_str());
+            log_warn_printf(io, "Server %s refuses channel to '%s' : %s\n", peerName.c_str(),
+                            chan->name.c_str(), sts.msg.c_str());
 
-    } else {
-        chan->state = Channel::Active;
-        chan->sid = sid;
+        } else {
+            chan->state = Channel::Active;
+            chan->sid = sid;
 
-        chanBySID[sid] = chan;
+            chanBySID[sid] = chan;
 
-        log_debug_printf(io, "Server %s active channel to '%s' %u:%u\n", peerName.c_str(),
-                         chan->name.c_str(), unsigned(chan->cid), unsigned(chan->sid));
+            log_debug_printf(io, "Server %s active channel to '%s' %u:%u\n", peerName.c_str(),
+                             chan->name.c_str(), unsigned(chan->cid), unsigned(chan->sid));
 
-        chan->createOperations();
+            chan->createOperations();
 
-        auto conns(chan->connectors); // copy list
+            auto conns(chan->connectors); // copy list
 
-        for(auto& conn : conns) {
-            if(!conn->_connected.exchange(true, std::memory_order_relaxed) && conn->_onConn)
-                conn->_onConn();
+            for(auto& conn : conns) {
+                if(!conn->_connected.exchange(true, std::memory_order_relaxed) && conn->_onConn)
+                    conn->_onConn();
+            }
         }
-    }
+    });
 }
 
 void Connection::handle_DESTROY_CHANNEL()
@@ -415,21 +590,24 @@ void Connection::handle_DESTROY_CHANNEL()
         }
     }
 
-    std::shared_ptr<Channel> chan;
-    {
-        auto it = chanBySID.find(sid);
-        if(it==chanBySID.end() || !(chan = it->second.lock())) {
-            log_debug_printf(io, "Server %s destroys non-existent channel %u:%u\n",
-                             peerName.c_str(), unsigned(cid), unsigned(sid));
-            return;
+    auto self(shared_from_this());
+    onContext([this, self, cid, sid]() {
+        std::shared_ptr<Channel> chan;
+        {
+            auto it = chanBySID.find(sid);
+            if(it==chanBySID.end() || !(chan = it->second.lock())) {
+                log_debug_printf(io, "Server %s destroys non-existent channel %u:%u\n",
+                                 peerName.c_str(), unsigned(cid), unsigned(sid));
+                return;
+            }
         }
-    }
 
-    chanBySID.erase(sid);
-    chan->disconnect(chan);
+        chanBySID.erase(sid);
+        chan->disconnect(chan);
 
-    log_debug_printf(io, "Server %s destroys channel '%s' %u:%u\n",
-                     peerName.c_str(), chan->name.c_str(), unsigned(cid), unsigned(sid));
+        log_debug_printf(io, "Server %s destroys channel '%s' %u:%u\n",
+                         peerName.c_str(), chan->name.c_str(), unsigned(cid), unsigned(sid));
+    });
 }
 
 void Connection::handle_MESSAGE()
@@ -447,13 +625,6 @@ void Connection::handle_MESSAGE()
     if(!M.good())
         throw std::runtime_error(SB()<<M.file()<<':'<<M.line()<<" Decode error for Message");
 
-    auto it = opByIOID.find(ioid);
-    if(it==opByIOID.end()) {
-        log_debug_printf(connsetup, "Server %s Message on non-existent ioid\n", peerName.c_str());
-        return;
-    }
-    auto op = it->second.handle.lock();
-
     Level lvl;
     switch(mtype) {
     case 0:  lvl = Level::Info; break;
@@ -462,8 +633,18 @@ void Connection::handle_MESSAGE()
     default: lvl = Level::Crit; break;
     }
 
-    log_printf(remote, lvl, "%s : %s\n",
-               op && op->chan ? op->chan->name.c_str() : "<dead>", msg.c_str());
+    auto self(shared_from_this());
+    onContext([this, self, ioid, lvl, msg]() {
+        auto it = opByIOID.find(ioid);
+        if(it==opByIOID.end()) {
+            log_debug_printf(connsetup, "Server %s Message on non-existent ioid\n", peerName.c_str());
+            return;
+        }
+        auto op = it->second.handle.lock();
+
+        log_printf(remote, lvl, "%s : %s\n",
+                   op && op->chan ? op->chan->name.c_str() : "<dead>", msg.c_str());
+    });
 }
 
 void Connection::tickEcho()
@@ -195,7 +195,7 @@ struct GPROp : public OperationBase
         }
         if(state==Creating || state==Idle || state==GetOPut || state==Exec) {
             // This opens up a race with an in-flight reply.
-            chan->conn->opByIOID.erase(ioid);
+            chan->conn->forgetOp(ioid);
             chan->opByIOID.erase(ioid);
         }
         bool ret = state!=Done;
@@ -290,9 +290,9 @@ struct GPROp : public OperationBase
         {
             auto& conn = chan->conn;
 
-            (void)evbuffer_drain(conn->txBody.get(), evbuffer_get_length(conn->txBody.get()));
+            (void)evbuffer_drain(conn->txMsg.get(), evbuffer_get_length(conn->txMsg.get()));
 
-            EvOutBuf R(conn->sendBE, conn->txBody.get());
+            EvOutBuf R(conn->txBE, conn->txMsg.get());
 
             to_wire(R, chan->sid);
             to_wire(R, ioid);
@@ -318,14 +318,14 @@ struct GPROp : public OperationBase
                 throw std::logic_error("Invalid state in GPR sendReply()");
             }
         }
-        chan->statTx += chan->conn->enqueueTxBody(state==GPROp::Done ? CMD_DESTROY_REQUEST :  (pva_app_msg_t)op);
+        chan->statTx += chan->conn->enqueueTx(state==GPROp::Done ? CMD_DESTROY_REQUEST :  (pva_app_msg_t)op);
 
         if(state==GPROp::Done) {
             // CMD_DESTROY_REQUEST is not acknowledged (sigh...)
             // but at this point a server should not send further GET/PUT/RPC w/ this IOID
             // so we can ~safely forget about it.
             // we might get CMD_MESSAGE, but these could be ignored with no ill effects.
-            chan->conn->opByIOID.erase(ioid);
+            chan->conn->forgetOp(ioid);
             chan->opByIOID.erase(ioid);
 
             notify();
@@ -341,9 +341,9 @@ struct GPROp : public OperationBase
         auto& conn = chan->conn;
 
         {
-            (void)evbuffer_drain(conn->txBody.get(), evbuffer_get_length(conn->txBody.get()));
+            (void)evbuffer_drain(conn->txMsg.get(), evbuffer_get_length(conn->txMsg.get()));
 
-            EvOutBuf R(conn->sendBE, conn->txBody.get());
+            EvOutBuf R(conn->txBE, conn->txMsg.get());
 
             to_wire(R, chan->sid);
             to_wire(R, ioid);
@@ -351,7 +351,7 @@ struct GPROp : public OperationBase
             to_wire(R, Value::Helper::desc(pvRequest));
             to_wire_full(R, pvRequest);
         }
-        chan->statTx += conn->enqueueTxBody(pva_app_msg_t(uint8_t(op)));
+        chan->statTx += conn->enqueueTx(pva_app_msg_t(uint8_t(op)));
 
         log_debug_printf(io, "Server %s channel '%s' op%02x INIT\n",
                          conn->peerName.c_str(), chan->name.c_str(), op);
@@ -422,13 +422,9 @@ void Connection::handle_GPR(pva_app_msg_t cmd)
 
     // need type info from INIT reply to decode PUT/GET
 
-    RequestInfo* info=nullptr;
     if(M.good()) {
-        auto it = opByIOID.find(ioid);
-        if(it!=opByIOID.end()) {
-            info = &it->second;
-
-        } else {
+        auto it = rxByIOID.find(ioid);
+        if(it==rxByIOID.end()) {
             if(cmd!=CMD_RPC && !init) {
                 rxRegistryDirty = true;
             }
@@ -437,28 +433,47 @@ void Connection::handle_GPR(pva_app_msg_t cmd)
                        peerName.c_str(), unsigned(ioid));
             return;
         }
+        auto& info = it->second;
 
         if(cmd!=CMD_RPC && init && sts.isSuccess()) {
             // INIT of PUT or GET, store type description
-            info->prototype = data;
+            info.prototype = data;
+            // prototype is updated on this worker by cache_sync() below,
+            // while the operation uses its copy on context->tcp_loop
+            if(ioWorker)
+                data = data.cloneEmpty();
 
         } else if(M.good() && !init && (cmd==CMD_GET || (cmd==CMD_PUT && get)) &&  sts.isSuccess()) {
             // GET reply
 
-            data = info->prototype.cloneEmpty();
+            data = info.prototype.cloneEmpty();
             if(data) {
                 from_wire_valid(M, rxRegistry, data);
-                cache_sync(info->prototype, data);
+                cache_sync(info.prototype, data);
             }
         }
     }
 
-    // validate received message against operation state
+    if(!M.good()) {
+        log_crit_printf(io, "%s:%d Server %s sends invalid op%02x.  Disconnecting...\n",
+                        M.file(), M.line(), peerName.c_str(), cmd);
+        bev.reset();
+        return;
+    }
+
+    auto self(shared_from_this());
+    onContext([this, self, cmd, rxlen, ioid, init, get, sts, data]() mutable {
+        // validate received message against operation state
 
-    std::shared_ptr<OperationBase> op;
-    GPROp* gpr = nullptr;
-    if(M.good() && info) {
-        op = info->handle.lock();
+        auto it = opByIOID.find(ioid);
+        if(it==opByIOID.end()) {
+            // cancelled since decoding
+            log_debug_printf(io, "Server %s ignoring stale cmd%02x ioid %u\n",
+                             peerName.c_str(), cmd, unsigned(ioid));
+            return;
+        }
+
+        auto op = it->second.handle.lock();
         if(!op) {
             // assume op has already sent CMD_DESTROY_REQUEST
             log_debug_printf(io, "Server %s ignoring stale cmd%02x ioid %u\n",
@@ -466,11 +481,8 @@ void Connection::handle_GPR(pva_app_msg_t cmd)
             return;
         }
 
-        if(uint8_t(op->op)!=cmd) {
-            // peer mixes up IOID and operation type
-            M.fault(__FILE__, __LINE__);
-
-        } else {
+        GPROp* gpr = nullptr;
+        if(uint8_t(op->op)==cmd) {
             gpr = static_cast<GPROp*>(op.get());
 
             // check that subcmd is as expected based on operation state
@@ -481,86 +493,87 @@ void Connection::handle_GPR(pva_app_msg_t cmd)
             } else if((gpr->state==GPROp::Exec) && !init && !get) {
 
             } else {
-                M.fault(__FILE__, __LINE__);
+                gpr = nullptr;
             }
         }
-    }
+        // else, peer mixes up IOID and operation type
 
-    if(!M.good() || !gpr) {
-        log_crit_printf(io, "%s:%d Server %s sends invalid op%02x.  Disconnecting...\n",
-                        M.file(), M.line(), peerName.c_str(), cmd);
-        bev.reset();
-        return;
-    }
+        if(!gpr) {
+            log_crit_printf(io, "Server %s sends invalid op%02x for ioid %u.  Disconnecting...\n",
+                            peerName.c_str(), cmd, unsigned(ioid));
+            forceDisconnect();
+            return;
+        }
 
-    gpr->chan->statRx += rxlen;
+        gpr->chan->statRx += rxlen;
 
-    // advance operation state
+        // advance operation state
 
-    decltype (gpr->state) prev = gpr->state;
+        decltype (gpr->state) prev = gpr->state;
 
-    if(!sts.isSuccess()) {
-        gpr->result = Result(std::make_exception_ptr(RemoteError(sts.msg)));
-        gpr->state = gpr->state==GPROp::Creating || gpr->autoExec ? GPROp::Done : GPROp::Idle;
+        if(!sts.isSuccess()) {
+            gpr->result = Result(std::make_exception_ptr(RemoteError(sts.msg)));
+            gpr->state = gpr->state==GPROp::Creating || gpr->autoExec ? GPROp::Done : GPROp::Idle;
 
-    } else if(gpr->state==GPROp::Creating) {
+        } else if(gpr->state==GPROp::Creating) {
 
-        gpr->state = GPROp::Idle;
-        if(cmd==CMD_PUT || cmd==CMD_GET)
-            gpr->arg = data; // save for later use in sendReply() when RequestInfo not available
+            gpr->state = GPROp::Idle;
+            if(cmd==CMD_PUT || cmd==CMD_GET)
+                gpr->arg = data; // save for later use in sendReply()
 
-        try {
-            if(gpr->onInit)
-                gpr->onInit(data);
-        } catch(std::exception& e) {
-            log_err_printf(setup, "Server %s op%02x \"%s\" onInit() error: %s\n",
-                           peerName.c_str(), cmd, gpr->chan->name.c_str(), e.what());
-            gpr->result = Result(std::current_exception());
-            gpr->state = GPROp::Done;
-            gpr->notify();
-        }
+            try {
+                if(gpr->onInit)
+                    gpr->onInit(data);
+            } catch(std::exception& e) {
+                log_err_printf(setup, "Server %s op%02x \"%s\" onInit() error: %s\n",
+                               peerName.c_str(), cmd, gpr->chan->name.c_str(), e.what());
+                gpr->result = Result(std::current_exception());
+                gpr->state = GPROp::Done;
+                gpr->notify();
+            }
 
-        if(gpr->state==GPROp::Idle && gpr->autoExec)
-            gpr->_reExec(!gpr->getOput);
-        // reply may now be sent, or deferred
-        return;
+            if(gpr->state==GPROp::Idle && gpr->autoExec)
+                gpr->_reExec(!gpr->getOput);
+            // reply may now be sent, or deferred
+            return;
 
-    } else if(gpr->state==GPROp::GetOPut) {
+        } else if(gpr->state==GPROp::GetOPut) {
 
-        gpr->arg.assign(data);
+            gpr->arg.assign(data);
 
-        if(gpr->autoExec) {
-            // proceed to execute put
-            gpr->state = GPROp::BuildPut;
+            if(gpr->autoExec) {
+                // proceed to execute put
+                gpr->state = GPROp::BuildPut;
 
-        } else {
-            // deliver get result
-            gpr->state = GPROp::Idle;
+            } else {
+                // deliver get result
+                gpr->state = GPROp::Idle;
+                gpr->result = Result(std::move(data), peerName);
+                gpr->notify();
+                return;
+            }
+
+        } else if(gpr->state==GPROp::Exec) {
+            // data always empty for CMD_PUT
             gpr->result = Result(std::move(data), peerName);
-            gpr->notify();
-            return;
-        }
 
-    } else if(gpr->state==GPROp::Exec) {
-        // data always empty for CMD_PUT
-        gpr->result = Result(std::move(data), peerName);
+            if(!gpr->autoExec) {
+                gpr->state = GPROp::Idle;
+                gpr->notify();
+                return;
+            }
+            gpr->state = GPROp::Done;
 
-        if(!gpr->autoExec) {
-            gpr->state = GPROp::Idle;
-            gpr->notify();
-            return;
+        } else {
+            // should be avoided above
+            throw std::logic_error("GPR advance state inconsistent");
         }
-        gpr->state = GPROp::Done;
-
-    } else {
-        // should be avoided above
-        throw std::logic_error("GPR advance state inconsistent");
-    }
 
-    log_debug_printf(io, "Server %s channel %s op%02x state %d -> %d\n",
-                     peerName.c_str(), gpr->chan->name.c_str(), cmd, prev, gpr->state);
+        log_debug_printf(io, "Server %s channel %s op%02x state %d -> %d\n",
+                         peerName.c_str(), gpr->chan->name.c_str(), cmd, prev, gpr->state);
 
-    gpr->sendReply();
+        gpr->sendReply();
+    });
 }
 
 void Connection::handle_GET() { handle_GPR(CMD_GET); }
@@ -7,6 +7,7 @@
 #define CLIENTIMPL_H
 
 #include <list>
+#include <array>
 
 #include <epicsTime.h>
 #include <epicsEvent.h>
@@ -25,6 +26,7 @@ namespace client {
 
 struct Channel;
 struct ContextImpl;
+struct RxInfo;
 
 struct ResultWaiter {
     epicsMutex lock;
@@ -56,40 +58,71 @@ struct OperationBase : public Operation
 
     virtual void createOp() =0;
     virtual void disconnected(const std::shared_ptr<OperationBase>& self) =0;
+    // what the Connection worker needs to decode replies
+    virtual RxInfo rxInfo() const;
 
     virtual const std::string& name() override final;
     virtual Value wait(double timeout=-1.0) override final;
     virtual void interrupt() override final;
 };
 
-struct RequestFL {
-    const size_t limit;
-    epicsMutex lock;
-    std::vector<Value> unused;
-
-    explicit RequestFL(size_t limit) :limit(limit) {}
-};
-
 struct RequestInfo {
     const uint32_t sid, ioid;
     const Operation::operation_t op;
     const std::weak_ptr<OperationBase> handle;
 
+    RequestInfo(uint32_t sid, uint32_t ioid, std::shared_ptr<OperationBase>& handle);
+};
+
+// Decoding state of an operation, kept by the Connection worker
+struct RxInfo {
+    Operation::operation_t op;
+    // when non-zero, size of monitor update pool
+    size_t poolSize = 0u;
+    // Monitor updates delivered without cache_sync() into prototype
+    bool deltaOnly = false;
+
     Value prototype;
-    std::shared_ptr<RequestFL> fl;
+    // Pool of pre-allocated monitor updates.
+    // An entry is re-used after the user releases a Value returned by pop().
+    ValuePool fl;
 
-    RequestInfo(uint32_t sid, uint32_t ioid, std::shared_ptr<OperationBase>& handle);
+    explicit RxInfo(Operation::operation_t op) :op(op) {}
 };
 
+/* Each Connection is serviced by one of ContextImpl::tcp_workers (loop),
+ * which owns the socket, and decodes received messages.
+ * Channel and operation state remains with ContextImpl::tcp_loop,
+ * where decoded messages are applied.  When tcpWorkers==1, these are the same loop.
+ */
 struct Connection final : public ConnBase, public std::enable_shared_from_this<Connection> {
     const std::shared_ptr<ContextImpl> context;
+    const evbase loop;
+    // index in ContextImpl::tcp_workers
+    const size_t worker;
+    // loop!=context->tcp_loop
+    const bool ioWorker;
+
+    // remaining members, and ConnBase, only accessible from loop worker
 
     // While HoldOff, the time until re-connection
     // While Connected, periodic Echo
     const evevent echoTimer;
 
+    // by IOID, entries added and removed along with opByIOID
+    std::map<uint32_t, RxInfo> rxByIOID;
+
+    // remaining members only accessible from context->tcp_loop
+
     bool ready = false;
     bool nameserver = false;
+    // no longer in context->connByAddr
+    bool closed = false;
+
+    // message body being built by Channel or operation.  cf. enqueueTx()
+    evbuf txMsg;
+    // byte order for txMsg, latched from ConnBase::sendBE on CONNECTION_VALIDATED
+    bool txBE;
 
     // channels to be created on this Connection in state==Connecting
     std::map<uint32_t, std::weak_ptr<Channel>> pending;
@@ -102,11 +135,26 @@ struct Connection final : public ConnBase, public std::enable_shared_from_this<C
 
     uint32_t nextIOID = 0x10002000u;
 
+    // on loop worker.  MONITOR update being decoded as segments arrive.  cf. handle_partial()
+    struct PartialUpdate {
+        const uint32_t ioid;
+        const uint8_t subcmd;
+        size_t rxlen = 0u;
+        Value data;
+        ValidDecoder decoder;
+        PartialUpdate(uint32_t ioid, uint8_t subcmd, Value&& data, TypeStore& ctxt)
+            :ioid(ioid), subcmd(subcmd), data(std::move(data)), decoder(ctxt, this->data)
+        {}
+    };
+    std::unique_ptr<PartialUpdate> rxPartial;
+    // current segmented message will not be decoded incrementally
+    bool rxPartialSkip = false;
+
     INST_COUNTER(Connection);
 
     Connection(const std::shared_ptr<ContextImpl>& context,
                const SockAddr &peerAddr,
-               bool reconn);
+               size_t worker);
     virtual ~Connection();
 
     static
@@ -114,14 +162,37 @@ struct Connection final : public ConnBase, public std::enable_shared_from_this<C
                                       const SockAddr& serv,
                                       bool reconn=false);
 
+    // queue fn to run on context->tcp_loop, or call now if already there
+    template<typename Fn>
+    void onContext(Fn&& fn);
+    // queue fn to run on loop, or call now if already there
+    template<typename Fn>
+    void onLoop(Fn&& fn);
+
 private:
+    void start(bool reconn);
     void startConnecting();
+    void sendRaw(const uint8_t* msg, size_t len);
 public:
 
     void createChannels();
 
+    // send, and clear, txMsg.  Returns the number of bytes queued
+    size_t enqueueTx(pva_app_msg_t cmd);
+    // forward a complete CMD_SEARCH message
+    void sendSearch(const uint8_t* msg, size_t len);
+
     void sendDestroyRequest(uint32_t sid, uint32_t ioid);
 
+    // begin tracking replies to a new operation
+    void addOp(uint32_t ioid, RxInfo&& info);
+    // stop tracking replies to ioid
+    void forgetOp(uint32_t ioid);
+
+    void forceDisconnect();
+    // after cleanup(), return Channels to searching.  Only once
+    void detach();
+
     virtual void bevEvent(short events) override final;
 
     virtual std::shared_ptr<ConnBase> self_from_this() override final;
@@ -145,6 +216,8 @@ public:
     CASE(MESSAGE);
 #undef CASE
 
+    virtual void handle_partial() override final;
+
     void handle_GPR(pva_app_msg_t cmd);
 protected:
     void tickEcho();
@@ -195,6 +268,8 @@ struct Channel {
 
     // when state==Searching, number of repetitions
     size_t nSearch = 0u;
+    // when state==Searching, number of search requests sent since last found
+    size_t nSearchSent = 0u;
 
     // GUID of last positive reply when state!=Searching
     ServerGUID guid{};
@@ -289,13 +364,41 @@ struct ContextImpl : public std::enable_shared_from_this<ContextImpl>
 
     // search destination address and whether to set the unicast flag
     std::vector<std::pair<SockEndpoint, bool>> searchDest;
+    // scratch for batched search TX
+    std::vector<sendmmsgx::Dest> searchBatch;
 
     size_t currentBucket = 0u;
-    // Channels where we have yet to send out an initial search request
+    // Channels where we have yet to send out an initial search request.
+    // Drained by initialSearcher, at most searchWindow packets at a time.
     std::list<std::weak_ptr<Channel>> initialSearchBucket;
     // Channels where we are waiting for a search response
     std::vector<std::list<std::weak_ptr<Channel>>> searchBuckets;
 
+    // Search response round trip time and loss estimate
+    struct SearchRTT {
+        // smoothed RTT and variation (seconds).  Meaningful when nSample!=0
+        double srtt = 0.0, rttvar = 0.0;
+        size_t nSample = 0u;
+        // names found by the first search sent, or only after a retry
+        size_t nFirst = 0u, nRetry = 0u;
+        void sample(double rtt);
+    };
+    // aggregate of all responders.  Sets the pace of initial search
+    SearchRTT searchRTT;
+    // per responder
+    std::map<SockAddr, SearchRTT> searchPeers;
+    // send time (epicsMonotonicGet()) of recent search requests, by searchSequenceID
+    std::array<std::pair<uint32_t, epicsUInt64>, 512u> searchSent{};
+    uint32_t searchSeq = 0u;
+    // max. number of initial search packets sent per pacing interval
+    size_t searchWindow;
+    // names found on first or later search since searchWindow was last adjusted
+    size_t winFirst = 0u, winRetry = 0u;
+    // consecutive check ticks which deferred retries for the initial search backlog
+    size_t searchDeferred = 0u;
+    // count of search datagrams sent
+    size_t statSearchTx = 0u;
+
     std::list<std::unique_ptr<UDPListener> > beaconRx;
 
     std::map<uint32_t, std::weak_ptr<Channel>> chanByCID;
@@ -309,6 +412,9 @@ struct ContextImpl : public std::enable_shared_from_this<ContextImpl>
     std::vector<std::pair<SockAddr, std::shared_ptr<Connection>>> nameServers;
 
     evbase tcp_loop;
+    // service Connections.  Filled in by Context::Pvt.
+    // Only tcp_loop when effective.tcpWorkers==1
+    std::vector<evbase> tcp_workers;
     const evevent searchRx4, searchRx6;
     const evevent searchTimer;
     const evevent initialSearcher;
@@ -330,6 +436,9 @@ struct ContextImpl : public std::enable_shared_from_this<ContextImpl>
 
     void startNS();
 
+    // select the least loaded of tcp_workers for a new Connection
+    size_t pickWorker();
+
     void close();
 
     void poke();
@@ -344,6 +453,9 @@ struct ContextImpl : public std::enable_shared_from_this<ContextImpl>
     static void onSearchS(evutil_socket_t fd, short evt, void *raw);
     enum class SearchKind { discover, initial, check };
     void tickSearch(SearchKind kind, bool poked);
+    SearchRTT* searchPeer(const SockAddr& peer);
+    void adaptSearchWindow();
+    timeval searchPace() const;
     static void tickSearchS(evutil_socket_t fd, short evt, void *raw);
     static void initialSearchS(evutil_socket_t fd, short evt, void *raw);
     void tickBeaconClean();
@@ -355,10 +467,12 @@ struct ContextImpl : public std::enable_shared_from_this<ContextImpl>
 };
 
 struct Context::Pvt {
-    // external ref to running loop.
+    // external refs to running loops.
     // impl directly, and indirectly, contains internal refs
 private:
     evbase loop;
+    // only when effective.tcpWorkers>1
+    std::vector<evbase> workers;
 public:
     const std::shared_ptr<ContextImpl> impl;
 
@@ -368,6 +482,24 @@ public:
     ~Pvt(); // I call ContextImpl::close()
 };
 
+template<typename Fn>
+void Connection::onContext(Fn&& fn)
+{
+    if(!ioWorker)
+        fn();
+    else
+        (void)context->tcp_loop.tryDispatch(std::forward<Fn>(fn));
+}
+
+template<typename Fn>
+void Connection::onLoop(Fn&& fn)
+{
+    if(!ioWorker)
+        fn();
+    else
+        (void)loop.tryDispatch(std::forward<Fn>(fn));
+}
+
 } // namespace client
 
 } // namespace pvxs
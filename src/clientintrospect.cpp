@@ -60,7 +60,7 @@ struct InfoOp : public OperationBase
             chan->conn->sendDestroyRequest(chan->sid, ioid);
 
             // This opens up a race with an in-flight reply.
-            chan->conn->opByIOID.erase(ioid);
+            chan->conn->forgetOp(ioid);
             chan->opByIOID.erase(ioid);
         }
         bool ret = state!=Done;
@@ -81,16 +81,16 @@ struct InfoOp : public OperationBase
         auto& conn = chan->conn;
 
         {
-            (void)evbuffer_drain(conn->txBody.get(), evbuffer_get_length(conn->txBody.get()));
+            (void)evbuffer_drain(conn->txMsg.get(), evbuffer_get_length(conn->txMsg.get()));
 
-            EvOutBuf R(conn->sendBE, conn->txBody.get());
+            EvOutBuf R(conn->txBE, conn->txMsg.get());
 
             to_wire(R, chan->sid);
             to_wire(R, ioid);
             // sub-field, which no one knows how to use...
             to_wire(R, "");
         }
-        chan->statTx += conn->enqueueTxBody(CMD_GET_FIELD);
+        chan->statTx += conn->enqueueTx(CMD_GET_FIELD);
 
         log_debug_printf(io, "Server %s channel '%s' GET_INFO\n", conn->peerName.c_str(), chan->name.c_str());
 
@@ -133,49 +133,52 @@ void Connection::handle_GET_FIELD()
         return;
     }
 
-    std::shared_ptr<Operation> op;
-    InfoOp* info;
-    {
-        auto it = opByIOID.find(ioid);
-        if(it==opByIOID.end()
-                || !(op = it->second.handle.lock())
-                || op->op!=Operation::Info) {
-            log_warn_printf(io, "Server %s sends stale GET_FIELD\n", peerName.c_str());
-            return;
+    auto self(shared_from_this());
+    onContext([this, self, rxlen, ioid, sts, prototype]() mutable {
+        std::shared_ptr<Operation> op;
+        InfoOp* info;
+        {
+            auto it = opByIOID.find(ioid);
+            if(it==opByIOID.end()
+                    || !(op = it->second.handle.lock())
+                    || op->op!=Operation::Info) {
+                log_warn_printf(io, "Server %s sends stale GET_FIELD\n", peerName.c_str());
+                return;
+            }
+            info = static_cast<InfoOp*>(op.get());
+            forgetOp(ioid);
+            info->chan->opByIOID.erase(ioid);
         }
-        info = static_cast<InfoOp*>(op.get());
-        opByIOID.erase(it);
-        info->chan->opByIOID.erase(ioid);
-    }
 
-    info->chan->statRx += rxlen;
+        info->chan->statRx += rxlen;
 
-    if(info->state!=InfoOp::Waiting) {
-        log_warn_printf(io, "Server %s ignore second reply to GET_FIELD\n", peerName.c_str());
-        return;
-    }
+        if(info->state!=InfoOp::Waiting) {
+            log_warn_printf(io, "Server %s ignore second reply to GET_FIELD\n", peerName.c_str());
+            return;
+        }
 
-    log_debug_printf(io, "Server %s completes GET_FIELD.\n", peerName.c_str());
+        log_debug_printf(io, "Server %s completes GET_FIELD.\n", peerName.c_str());
 
-    info->state = InfoOp::Done;
+        info->state = InfoOp::Done;
+
+        if(info->done) {
+            auto done = std::move(info->done);
+            Result res;
+            if(sts.isSuccess()) {
+                res = Result(std::move(prototype), peerName);
+            } else {
+                res = Result(std::make_exception_ptr(RemoteError(sts.msg)));
+            }
+            try {
+                done(std::move(res));
+            }catch(std::exception& e){
+                log_exc_printf(setup, "Unhandled exception %s in Info result() callback: %s\n", typeid (e).name(), e.what());
+            }
 
-    if(info->done) {
-        auto done = std::move(info->done);
-        Result res;
-        if(sts.isSuccess()) {
-            res = Result(std::move(prototype), peerName);
         } else {
-            res = Result(std::make_exception_ptr(RemoteError(sts.msg)));
-        }
-        try {
-            done(std::move(res));
-        }catch(std::exception& e){
-            log_exc_printf(setup, "Unhandled exception %s in Info result() callback: %s\n", typeid (e).name(), e.what());
+            info->result = prototype;
         }
-
-    } else {
-        info->result = prototype;
-    }
+    });
 }
 
 std::shared_ptr<Operation> GetBuilder::_exec_info()
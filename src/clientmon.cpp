@@ -8,7 +8,6 @@
 #include <epicsMutex.h>
 #include <epicsGuard.h>
 
-#include <deque>
 
 #include <pvxs/log.h>
 #include "clientimpl.h"
@@ -46,6 +45,7 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
     bool pipeline = false;
     bool autostart = true;
     bool maskConn = false, maskDiscon = true;
+    bool deltaOnly = false;
     uint32_t queueSize = 4u, ackAt=0u;
 
     // only access from loop
@@ -63,7 +63,7 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
 
     // guarded by lock
 
-    std::deque<Entry> queue;
+    RingQueue<Entry> queue;
     uint32_t window =0u; // flow control window.  number of updates server may send to us
     uint32_t unack =0u;  // updates pop()'d, but not ack'd
     size_t nSrvSquash =0u;
@@ -129,15 +129,15 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
                 {
                     uint8_t subcmd = p ? 0x04 : 0x44; // STOP | START
 
-                    (void)evbuffer_drain(conn->txBody.get(), evbuffer_get_length(conn->txBody.get()));
+                    (void)evbuffer_drain(conn->txMsg.get(), evbuffer_get_length(conn->txMsg.get()));
 
-                    EvOutBuf R(conn->sendBE, conn->txBody.get());
+                    EvOutBuf R(conn->txBE, conn->txMsg.get());
 
                     to_wire(R, chan->sid);
                     to_wire(R, ioid);
                     to_wire(R, subcmd);
                 }
-                chan->statTx += conn->enqueueTxBody(CMD_MONITOR);
+                chan->statTx += conn->enqueueTx(CMD_MONITOR);
 
                 state = p ? Idle : Running;
             }
@@ -303,7 +303,7 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
             chan->conn->sendDestroyRequest(chan->sid, ioid);
 
             // This opens up a race with an in-flight reply.
-            chan->conn->opByIOID.erase(ioid);
+            chan->conn->forgetOp(ioid);
             chan->opByIOID.erase(ioid);
 
             if(pipeline)
@@ -319,6 +319,17 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
     void _reExecGet(std::function<void(client::Result&&)>&& resultcb) override final {}
     void _reExecPut(const Value& arg, std::function<void(client::Result&&)>&& resultcb) override final {}
 
+    virtual RxInfo rxInfo() const override final
+    {
+        RxInfo ret(op);
+        /* Allow enough for user to hold/process one full queue while
+         * accumulate another.
+         */
+        ret.poolSize = 2u*queueSize;
+        ret.deltaOnly = deltaOnly;
+        return ret;
+    }
+
     virtual void createOp() override final
     {
         if(state!=Connecting) {
@@ -332,9 +343,9 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
             if(pipeline)
                 subcmd |= 0x80;
 
-            (void)evbuffer_drain(conn->txBody.get(), evbuffer_get_length(conn->txBody.get()));
+            (void)evbuffer_drain(conn->txMsg.get(), evbuffer_get_length(conn->txMsg.get()));
 
-            EvOutBuf R(conn->sendBE, conn->txBody.get());
+            EvOutBuf R(conn->txBE, conn->txMsg.get());
 
             to_wire(R, chan->sid);
             to_wire(R, ioid);
@@ -344,7 +355,7 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
             if(pipeline)
                 to_wire(R, queueSize);
         }
-        chan->statTx += conn->enqueueTxBody(CMD_MONITOR);
+        chan->statTx += conn->enqueueTx(CMD_MONITOR);
 
         log_debug_printf(io, "Server %s channel '%s' monitor INIT%s q=%u a=%u\n",
                          conn->peerName.c_str(), chan->name.c_str(), pipeline?" pipeline":"",
@@ -436,16 +447,16 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
 
             auto& conn = chan->conn;
             {
-                (void)evbuffer_drain(conn->txBody.get(), evbuffer_get_length(conn->txBody.get()));
+                (void)evbuffer_drain(conn->txMsg.get(), evbuffer_get_length(conn->txMsg.get()));
 
-                EvOutBuf R(conn->sendBE, conn->txBody.get());
+                EvOutBuf R(conn->txBE, conn->txMsg.get());
 
                 to_wire(R, chan->sid);
                 to_wire(R, ioid);
                 to_wire(R, uint8_t(0x80));
                 to_wire(R, uint32_t(num2ack));
             }
-            chan->statTx += conn->enqueueTxBody(CMD_MONITOR);
+            chan->statTx += conn->enqueueTx(CMD_MONITOR);
         }
     }
     static
@@ -461,8 +472,50 @@ struct SubscriptionImpl final : public OperationBase, public Subscription
 };
 DEFINE_INST_COUNTER(SubscriptionImpl);
 
+void Connection::handle_partial()
+{
+    if(segCmd!=CMD_MONITOR || rxPartialSkip)
+        return;
+
+    if(!rxPartial) {
+        // begin with a data update to a known subscription.
+        // Leave anything else for handle_MONITOR()
+        uint8_t header[5];
+        if(evbuffer_copyout(segBuf.get(), header, sizeof(header))!=sizeof(header))
+            return; // wait for next segment
+
+        FixedBuf H(peerBE, header, sizeof(header));
+        uint32_t ioid=0;
+        uint8_t subcmd=0;
+        from_wire(H, ioid);
+        from_wire(H, subcmd);
+
+        auto it = rxByIOID.find(ioid);
+        if(!H.good() || (subcmd&(0x08|0x10)) || it==rxByIOID.end()
+                || it->second.op!=Operation::Monitor || !it->second.fl) {
+            rxPartialSkip = true;
+            return;
+        }
+
+        evbuffer_drain(segBuf.get(), sizeof(header));
+        rxPartial.reset(new PartialUpdate(ioid, subcmd, it->second.fl.create(), rxRegistry));
+        rxPartial->rxlen = sizeof(header);
+    }
+
+    auto before = evbuffer_get_length(segBuf.get());
+    rxPartial->decoder.decode(segBuf.get(), peerBE, false);
+    rxPartial->rxlen += 8u + before - evbuffer_get_length(segBuf.get());
+}
+
 void Connection::handle_MONITOR()
 {
+    // maybe partially decoded by handle_partial()
+    std::unique_ptr<PartialUpdate> partial(std::move(rxPartial));
+    rxPartialSkip = false;
+
+    if(partial)
+        partial->decoder.decode(segBuf.get(), peerBE, true);
+
     auto rxlen = 8u + evbuffer_get_length(segBuf.get());
     EvInBuf M(peerBE, segBuf.get(), 16);
 
@@ -471,8 +524,17 @@ void Connection::handle_MONITOR()
     Status sts{};
     Value data; // hold prototype (INIT) or reply data
 
-    from_wire(M, ioid);
-    from_wire(M, subcmd);
+    if(partial) {
+        ioid = partial->ioid;
+        subcmd = partial->subcmd;
+        rxlen += partial->rxlen;
+        if(!partial->decoder.good())
+            M.fault(partial->decoder.file(), partial->decoder.line());
+
+    } else {
+        from_wire(M, ioid);
+        from_wire(M, subcmd);
+    }
     bool init = subcmd&0x08;
     bool final = subcmd&0x10;
 
@@ -481,14 +543,11 @@ void Connection::handle_MONITOR()
     if(init && sts.isSuccess())
         from_wire_type(M, rxRegistry, data);
 
-    RequestInfo* info=nullptr;
     bool servSquash = false;
+    Value prototype; // copy for onInit()
     if(M.good()) {
-        auto it = opByIOID.find(ioid);
-        if(it!=opByIOID.end()) {
-            info = &it->second;
-
-        } else {
+        auto it = rxByIOID.find(ioid);
+        if(it==rxByIOID.end()) {
             if(!init) {
                 rxRegistryDirty = true;
             }
@@ -497,57 +556,29 @@ void Connection::handle_MONITOR()
                        peerName.c_str(), unsigned(ioid));
             return;
         }
+        auto& info = it->second;
 
         if(!sts.isSuccess()) {
 
         } else if(init) {
-            info->prototype = std::move(data);
-            // initialize info->fl later, with access to queueSize
+            info.prototype = std::move(data);
+            if(info.poolSize)
+                info.fl = ValuePool(info.prototype, info.poolSize);
+            // prototype is updated on this worker by cache_sync() below
+            prototype = ioWorker ? info.prototype.cloneEmpty() : info.prototype;
 
         } else if(!final || !M.empty()) {
 
-            // Take from free-list of pre-allocated Value
-            Value raw;
-            {
-                Guard G(info->fl->lock);
-
-                if(!info->fl->unused.empty()) {
-                    raw = std::move(info->fl->unused.back());
-                    info->fl->unused.pop_back();
+            if(partial) {
+                data = std::move(partial->data);
 
-                } else {
-                    raw = info->prototype.cloneEmpty();
-                }
-            }
-            // Wrap Value for automatic return to our free-list
-            {
-                std::weak_ptr<RequestFL> wfl(info->fl);
-                auto desc(Value::Helper::desc(raw));
-                auto store(Value::Helper::store_ptr(raw));
-
-                Value::Helper::store(data).reset(
-                            store,
-                            // ugly bind() to capture by move instead of copy to avoid extra ref-counts
-                            std::bind(
-                            [](FieldStorage*, Value& data, std::weak_ptr<RequestFL>& wfl) mutable {
-                                // maybe on worker or user thread
-                                auto real(std::move(data));
-                                if(auto fl = wfl.lock()) {
-                                    Guard G(fl->lock);
-                                    if(fl->unused.size() < fl->limit) {
-                                        real.clear();
-                                        fl->unused.emplace_back(std::move(real));
-                                    }
-                                }
-
-                }, std::placeholders::_1, std::move(raw), std::move(wfl))
-                            );
-
-                Value::Helper::set_desc(data, desc);
+            } else {
+                data = info.fl.create();
+                from_wire_valid(M, rxRegistry, data);
             }
-            from_wire_valid(M, rxRegistry, data);
 
-            cache_sync(info->prototype, data);
+            if(!info.deltaOnly)
+                cache_sync(info.prototype, data);
 
             BitMask overrun;
             from_wire(M, overrun);
@@ -563,12 +594,26 @@ void Connection::handle_MONITOR()
         }
     }
 
-    // validate received message against operation state
+    if(!M.good()) {
+        log_crit_printf(io, "%s:%d Server %s sends invalid MONITOR.  Disconnecting...\n",
+                        M.file(), M.line(), peerName.c_str());
+        bev.reset();
+        return;
+    }
+
+    auto self(shared_from_this());
+    onContext([this, self, rxlen, ioid, init, final, sts, data, prototype, servSquash]() mutable {
+        // validate received message against operation state
 
-    std::shared_ptr<OperationBase> op;
-    SubscriptionImpl* mon = nullptr;
-    if(M.good() && info) {
-        op = info->handle.lock();
+        auto it = opByIOID.find(ioid);
+        if(it==opByIOID.end()) {
+            // cancelled since decoding
+            log_debug_printf(io, "Server %s ignoring stale cmd%02x ioid %u\n",
+                             peerName.c_str(), CMD_MONITOR, unsigned(ioid));
+            return;
+        }
+
+        auto op = it->second.handle.lock();
         if(!op) {
             // assume op has already sent CMD_DESTROY_REQUEST
             log_debug_printf(io, "Server %s ignoring stale cmd%02x ioid %u\n",
@@ -576,11 +621,8 @@ void Connection::handle_MONITOR()
             return;
         }
 
-        if(uint8_t(op->op)!=CMD_MONITOR) {
-            // peer mixes up IOID and operation type
-            M.fault(__FILE__, __LINE__);
-
-        } else {
+        SubscriptionImpl* mon = nullptr;
+        if(uint8_t(op->op)==CMD_MONITOR) {
             mon = static_cast<SubscriptionImpl*>(op.get());
 
             // check that subcmd is as expected based on operation state
@@ -591,150 +633,148 @@ void Connection::handle_MONITOR()
             } else if((mon->state==SubscriptionImpl::Running) && !init) {
 
             } else {
-                M.fault(__FILE__, __LINE__);
+                mon = nullptr;
             }
         }
-    }
-
-    if(!M.good() || !mon) {
-        log_crit_printf(io, "%s:%d Server %s sends invalid MONITOR.  Disconnecting...\n",
-                        M.file(), M.line(), peerName.c_str());
-        bev.reset();
-        return;
-    }
+        // else, peer mixes up IOID and operation type
 
-    mon->chan->statRx += rxlen;
-
-    Entry update;
-
-    if(!sts.isSuccess()) {
-        update.exc = std::make_exception_ptr(RemoteError(sts.msg));
-        mon->state = SubscriptionImpl::Done;
+        if(!mon) {
+            log_crit_printf(io, "Server %s sends invalid MONITOR for ioid %u.  Disconnecting...\n",
+                            peerName.c_str(), unsigned(ioid));
+            forceDisconnect();
+            return;
+        }
 
-    } else if(mon->state==SubscriptionImpl::Creating) {
-        log_debug_printf(io, "Server %s channel %s monitor Created\n",
-                        peerName.c_str(),
-                        mon->chan->name.c_str());
+        mon->chan->statRx += rxlen;
 
-        mon->state = SubscriptionImpl::Idle;
+        Entry update;
 
-        try {
-            if(mon->onInit)
-                mon->onInit(*mon, info->prototype);
-        }catch(std::exception& e){
+        if(!sts.isSuccess()) {
+            update.exc = std::make_exception_ptr(RemoteError(sts.msg));
             mon->state = SubscriptionImpl::Done;
-            update.exc = std::current_exception();
-            log_debug_printf(io, "Server %s channel %s monitor Create error: %s\n",
+
+        } else if(mon->state==SubscriptionImpl::Creating) {
+            log_debug_printf(io, "Server %s channel %s monitor Created\n",
                             peerName.c_str(),
-                            mon->chan->name.c_str(), e.what());
-        }
+                            mon->chan->name.c_str());
 
-        if(mon->autostart && mon->state == SubscriptionImpl::Idle)
-            mon->resume();
+            mon->state = SubscriptionImpl::Idle;
 
-    } else if(data) { // Idle or Running
-        update.val = std::move(data);
+            try {
+                if(mon->onInit)
+                    mon->onInit(*mon, prototype);
+            }catch(std::exception& e){
+                mon->state = SubscriptionImpl::Done;
+                update.exc = std::current_exception();
+                log_debug_printf(io, "Server %s channel %s monitor Create error: %s\n",
+                                peerName.c_str(),
+                                mon->chan->name.c_str(), e.what());
+            }
 
-    } else {
-        // NULL update.  can this happen?
-        log_debug_printf(io, "Server %s channel %s monitor RX NULL\n",
-                        peerName.c_str(),
-                        mon->chan->name.c_str());
-    }
+            if(mon->autostart && mon->state == SubscriptionImpl::Idle)
+                mon->resume();
 
-    bool notify = false;
-    {
-        Guard G(mon->lock);
+        } else if(data) { // Idle or Running
+            update.val = std::move(data);
 
-        if(init && !sts.isSuccess()) {
-            log_debug_printf(io, "Server %s channel %s monitor PUSH init error\n",
+        } else {
+            // NULL update.  can this happen?
+            log_debug_printf(io, "Server %s channel %s monitor RX NULL\n",
                             peerName.c_str(),
                             mon->chan->name.c_str());
+        }
 
-            mon->queue.emplace_back(std::move(update));
-            notify = true;
+        bool notify = false;
+        {
+            Guard G(mon->lock);
 
-        } else if(init) {
-            /* Allow enough for user to hold/process one full queue while
-             * accumulate another.
-             */
-            info->fl = std::make_shared<RequestFL>(2u*mon->queueSize);
+            if(init && !sts.isSuccess()) {
+                log_debug_printf(io, "Server %s channel %s monitor PUSH init error\n",
+                                peerName.c_str(),
+                                mon->chan->name.c_str());
 
-        } else {
+                mon->queue.emplace_back(std::move(update));
+                notify = true;
 
-            if(mon->pipeline) {
-                if(mon->window) {
-                    mon->window--;
+            } else if(init) {
+                // update pool created on worker
 
-                    if(!mon->window)
-                        log_debug_printf(io, "Server %s channel '%s' MONITOR zero window w/ %u\n",
-                                        peerName.c_str(), mon->chan->name.c_str(), unsigned(mon->unack));
+            } else {
+
+                if(mon->pipeline) {
+                    if(mon->window) {
+                        mon->window--;
 
-                } else if(!final) {
-                    log_err_printf(io, "Server %s channel '%s' MONITOR exceeds window size\n",
-                                    peerName.c_str(), mon->chan->name.c_str());
+                        if(!mon->window)
+                            log_debug_printf(io, "Server %s channel '%s' MONITOR zero window w/ %u\n",
+                                            peerName.c_str(), mon->chan->name.c_str(), unsigned(mon->unack));
+
+                    } else if(!final) {
+                        log_err_printf(io, "Server %s channel '%s' MONITOR exceeds window size\n",
+                                        peerName.c_str(), mon->chan->name.c_str());
+                    }
                 }
-            }
 
-            notify = mon->queue.empty();
+                notify = mon->queue.empty();
 
-            assert(mon->queueSize >= 1u);
-            if(update.val && mon->queue.size() >= mon->queueSize && mon->queue.back().val && !mon->pipeline) {
-                log_debug_printf(io, "Server %s channel %s monitor Squash\n",
-                                 peerName.c_str(),
-                                 mon->chan->name.c_str());
+                assert(mon->queueSize >= 1u);
+                if(update.val && mon->queue.size() >= mon->queueSize && mon->queue.back().val && !mon->pipeline) {
+                    log_debug_printf(io, "Server %s channel %s monitor Squash\n",
+                                     peerName.c_str(),
+                                     mon->chan->name.c_str());
 
-                mon->queue.back().val.assign(update.val);
-                mon->nCliSquash++;
+                    mon->queue.back().val.assign(update.val);
+                    mon->nCliSquash++;
 
-            } else if(update.exc || update.val) {
-                log_debug_printf(io, "Server %s channel %s monitor PUSH\n",
-                                peerName.c_str(),
-                                mon->chan->name.c_str());
+                } else if(update.exc || update.val) {
+                    log_debug_printf(io, "Server %s channel %s monitor PUSH\n",
+                                    peerName.c_str(),
+                                    mon->chan->name.c_str());
 
-                mon->queue.emplace_back(std::move(update));
+                    mon->queue.emplace_back(std::move(update));
 
-            }
+                }
 
-            if(final) {
-                log_debug_printf(io, "Server %s channel %s monitor FINISH\n",
-                                peerName.c_str(),
-                                mon->chan->name.c_str());
+                if(final) {
+                    log_debug_printf(io, "Server %s channel %s monitor FINISH\n",
+                                    peerName.c_str(),
+                                    mon->chan->name.c_str());
 
-                mon->queue.emplace_back(std::make_exception_ptr(Finished()));
-            }
+                    mon->queue.emplace_back(std::make_exception_ptr(Finished()));
+                }
 
-            if(mon->queue.empty()) {
-                log_err_printf(io, "Server %s channel '%s' monitor empty update!\n",
-                               peerName.c_str(), mon->chan->name.c_str());
-                notify = false;
-            }
+                if(mon->queue.empty()) {
+                    log_err_printf(io, "Server %s channel '%s' monitor empty update!\n",
+                                   peerName.c_str(), mon->chan->name.c_str());
+                    notify = false;
+                }
 
-            if(mon->queueMax < mon->queue.size())
-                mon->queueMax = mon->queue.size();
-        }
+                if(mon->queueMax < mon->queue.size())
+                    mon->queueMax = mon->queue.size();
+            }
 
-        if(notify)
-            notify = mon->wantToNotify();
-        if(servSquash)
-            mon->nSrvSquash++;
-    } // release mon->lock
+            if(notify)
+                notify = mon->wantToNotify();
+            if(servSquash)
+                mon->nSrvSquash++;
+        } // release mon->lock
 
-    if(mon->state==SubscriptionImpl::Done || final) {
-        mon->state=SubscriptionImpl::Done;
+        if(mon->state==SubscriptionImpl::Done || final) {
+            mon->state=SubscriptionImpl::Done;
 
-        opByIOID.erase(ioid);
-        mon->chan->opByIOID.erase(ioid);
+            forgetOp(ioid);
+            mon->chan->opByIOID.erase(ioid);
 
-        if(mon->pipeline)
-            (void)event_del(mon->ackTick.get());
+            if(mon->pipeline)
+                (void)event_del(mon->ackTick.get());
 
-        if(!final)
-            sendDestroyRequest(mon->chan->sid, ioid);
-    }
+            if(!final)
+                sendDestroyRequest(mon->chan->sid, ioid);
+        }
 
-    if(notify)
-        mon->doNotify();
+        if(notify)
+            mon->doNotify();
+    });
 }
 
 
@@ -753,6 +793,7 @@ std::shared_ptr<Subscription> MonitorBuilder::exec()
     op->pvRequest = _buildReq();
     op->maskConn = _maskConn;
     op->maskDiscon = _maskDisconn;
+    op->deltaOnly = _deltaOnly;
     op->autostart = _autoexec;
 
     auto options = op->pvRequest["record._options"];
@@ -797,6 +838,9 @@ std::shared_ptr<Subscription> MonitorBuilder::exec()
 
     op->ackAt = std::max(1u, std::min(op->ackAt, op->queueSize));
 
+    // room for a full queue, plus connect/disconnect/finish events
+    op->queue.reserve(std::min<size_t>(op->queueSize+2u, 1024u));
+
     auto syncCancel(_syncCancel);
     std::shared_ptr<SubscriptionImpl> external(op.get(), [op, syncCancel](SubscriptionImpl*) mutable {
         // from user thread
@@ -20,6 +20,7 @@
 #include <pvxs/log.h>
 #include "serverconn.h"
 #include "clientimpl.h"
+#include "udp_collector.h"
 #include "utilpvt.h"
 #include "evhelper.h"
 
@@ -226,6 +227,21 @@ void parse_timeout(double& dest, const std::string& name, const std::string& val
     }
 }
 
+void parse_unsigned(unsigned& dest, const std::string& name, const std::string& val)
+{
+    try {
+        auto temp = parseTo<uint64_t>(val);
+
+        if(temp > std::numeric_limits<unsigned>::max())
+            throw std::out_of_range("Out of range");
+
+        dest = unsigned(temp);
+    } catch(std::exception& e) {
+        log_err_printf(config, "%s invalid unsigned value : '%s'\n",
+                       name.c_str(), val.c_str());
+    }
+}
+
 struct PickOne {
     const std::map<std::string, std::string>& defs;
     bool useenv;
@@ -369,6 +385,53 @@ void removeDups(std::vector<SockEndpoint>& addrs)
     }
 }
 
+// Segments smaller than this would be mostly header
+static
+constexpr size_t minSegmentSize = 1024u;
+
+static
+void enforceSegmentSize(size_t& seg)
+{
+    if(seg && seg < minSegmentSize)
+        seg = minSegmentSize;
+    else if(seg > std::numeric_limits<uint32_t>::max())
+        seg = 0u; // can't be exceeded anyway
+}
+
+// message lengths are 32-bit
+static
+void enforceReserveMax(size_t& lim)
+{
+    if(lim > std::numeric_limits<uint32_t>::max())
+        lim = std::numeric_limits<uint32_t>::max();
+}
+
+// more workers would only add threads and contention
+constexpr unsigned maxTcpWorkers = 256u;
+
+void enforceTcpWorkers(unsigned& nworkers)
+{
+    if(nworkers==0u) {
+        nworkers = 1u;
+    } else if(nworkers > maxTcpWorkers) {
+        log_warn_printf(config, "tcpWorkers=%u exceeds maximum.  Using %u\n",
+                        nworkers, maxTcpWorkers);
+        nworkers = maxTcpWorkers;
+    }
+}
+
+// longer than a second would be a latency bug, not an optimization
+constexpr unsigned maxTcpFlushDelay = 1000000u;
+
+void enforceTcpFlushDelay(unsigned& delay)
+{
+    if(delay > maxTcpFlushDelay) {
+        log_warn_printf(config, "tcpFlushDelay=%u exceeds maximum.  Using %u\n",
+                        delay, maxTcpFlushDelay);
+        delay = maxTcpFlushDelay;
+    }
+}
+
 void enforceTimeout(double& tmo)
 {
     /* Inactivity timeouts with PVA have a long (and growing) history.
@@ -391,6 +454,42 @@ void enforceTimeout(double& tmo)
 
 } // namespace
 
+namespace impl {
+
+static
+size_t readUdpRxBatch()
+{
+    size_t batch = 4u;
+    if(auto env = getenv("PVXS_UDP_BATCH")) {
+        try {
+            auto val = parseTo<uint64_t>(env);
+            if(val==0u) {
+                log_warn_printf(config, "PVXS_UDP_BATCH=%s must be positive.  Using %u\n",
+                                env, unsigned(batch));
+            } else if(val > recvmmsgx::maxBatch) {
+                batch = recvmmsgx::maxBatch;
+                log_warn_printf(config, "PVXS_UDP_BATCH=%s exceeds maximum.  Using %u\n",
+                                env, unsigned(batch));
+            } else {
+                batch = size_t(val);
+            }
+        } catch(std::exception& e) {
+            log_warn_printf(config, "PVXS_UDP_BATCH=%s invalid integer : %s.  Using %u\n",
+                            env, e.what(), unsigned(batch));
+        }
+    }
+    return batch;
+}
+
+size_t udpRxBatch()
+{
+    // shared by all UDPManager instances, so read and checked once
+    static const size_t batch = readUdpRxBatch();
+    return batch;
+}
+
+} // namespace impl
+
 namespace server {
 
 static
@@ -433,6 +532,45 @@ void _fromDefs(Config& self, const std::map<std::string, std::string>& defs, boo
     if(pickone({"EPICS_PVA_CONN_TMO"})) {
         parse_timeout(self.tcpTimeout, pickone.name, pickone.val);
     }
+
+    if(pickone({"EPICS_PVAS_TCP_WORKERS"})) {
+        parse_unsigned(self.tcpWorkers, pickone.name, pickone.val);
+    }
+
+    if(pickone({"EPICS_PVAS_TCP_SEGMENT_SIZE"})) {
+        try {
+            self.tcpSegmentSize = parseTo<uint64_t>(pickone.val);
+        }catch(std::exception& e) {
+            log_err_printf(serversetup, "%s invalid integer : %s", pickone.name.c_str(), e.what());
+        }
+    }
+
+    if(pickone({"EPICS_PVAS_TCP_RESERVE_MAX"})) {
+        try {
+            self.tcpReserveMax = size_t(std::min<uint64_t>(parseTo<uint64_t>(pickone.val),
+                                                           std::numeric_limits<uint32_t>::max()));
+        }catch(std::exception& e) {
+            log_err_printf(serversetup, "%s invalid integer : %s", pickone.name.c_str(), e.what());
+        }
+    }
+
+    if(pickone({"EPICS_PVAS_TCP_FLUSH_DELAY"})) {
+        try {
+            // saturate, enforceTcpFlushDelay() will warn
+            self.tcpFlushDelay = unsigned(std::min<uint64_t>(parseTo<uint64_t>(pickone.val),
+                                                             std::numeric_limits<unsigned>::max()));
+        }catch(std::exception& e) {
+            log_err_printf(serversetup, "%s invalid integer : %s", pickone.name.c_str(), e.what());
+        }
+    }
+
+    if(pickone({"EPICS_PVAS_TCP_FLUSH_BYTES"})) {
+        try {
+            self.tcpFlushBytes = parseTo<uint64_t>(pickone.val);
+        }catch(std::exception& e) {
+            log_err_printf(serversetup, "%s invalid integer : %s", pickone.name.c_str(), e.what());
+        }
+    }
 }
 
 Config& Config::applyEnv()
@@ -479,6 +617,11 @@ void Config::updateDefs(defs_t& defs) const
     defs["EPICS_PVA_INTF_ADDR_LIST"] = defs["EPICS_PVAS_INTF_ADDR_LIST"]   = join_addr(interfaces);
     defs["EPICS_PVAS_IGNORE_ADDR_LIST"]   = join_addr(ignoreAddrs);
     defs["EPICS_PVA_CONN_TMO"] = SB()<<tcpTimeout/tmoScale;
+    defs["EPICS_PVAS_TCP_WORKERS"] = SB()<<tcpWorkers;
+    defs["EPICS_PVAS_TCP_SEGMENT_SIZE"] = SB()<<tcpSegmentSize;
+    defs["EPICS_PVAS_TCP_RESERVE_MAX"] = SB()<<tcpReserveMax;
+    defs["EPICS_PVAS_TCP_FLUSH_DELAY"] = SB()<<tcpFlushDelay;
+    defs["EPICS_PVAS_TCP_FLUSH_BYTES"] = SB()<<tcpFlushBytes;
 }
 
 void Config::expand()
@@ -525,6 +668,15 @@ void Config::expand()
 
     enforceTimeout(tcpTimeout);
 
+    enforceTcpWorkers(tcpWorkers);
+
+    enforceSegmentSize(tcpSegmentSize);
+
+    enforceReserveMax(tcpReserveMax);
+
+    enforceTcpFlushDelay(tcpFlushDelay);
+    if(!tcpFlushBytes)
+        tcpFlushBytes = 16384u;
 }
 
 std::ostream& operator<<(std::ostream& strm, const Config& conf)
@@ -595,6 +747,31 @@ void _fromDefs(Config& self, const std::map<std::string, std::string>& defs, boo
     if(pickone({"EPICS_PVA_CONN_TMO"})) {
         parse_timeout(self.tcpTimeout, pickone.name, pickone.val);
     }
+
+    if(pickone({"EPICS_PVA_TCP_WORKERS"})) {
+        parse_unsigned(self.tcpWorkers, pickone.name, pickone.val);
+    }
+
+    if(pickone({"EPICS_PVA_TCP_SEGMENT_SIZE"})) {
+        try {
+            self.tcpSegmentSize = parseTo<uint64_t>(pickone.val);
+        }catch(std::exception& e) {
+            log_warn_printf(clientsetup, "%s invalid integer : %s", pickone.name.c_str(), e.what());
+        }
+    }
+
+    if(pickone({"EPICS_PVA_TCP_RESERVE_MAX"})) {
+        try {
+            self.tcpReserveMax = size_t(std::min<uint64_t>(parseTo<uint64_t>(pickone.val),
+                                                           std::numeric_limits<uint32_t>::max()));
+        }catch(std::exception& e) {
+            log_warn_printf(clientsetup, "%s invalid integer : %s", pickone.name.c_str(), e.what());
+        }
+    }
+
+    if(pickone({"EPICS_PVA_CREATE_BATCH"})) {
+        parse_unsigned(self.createBatch, pickone.name, pickone.val);
+    }
 }
 
 Config& Config::applyEnv()
@@ -618,6 +795,10 @@ void Config::updateDefs(defs_t& defs) const
     defs["EPICS_PVA_INTF_ADDR_LIST"] = join_addr(interfaces);
     defs["EPICS_PVA_CONN_TMO"] = SB()<<tcpTimeout/tmoScale;
     defs["EPICS_PVA_NAME_SERVERS"] = join_addr(nameServers);
+    defs["EPICS_PVA_TCP_WORKERS"] = SB()<<tcpWorkers;
+    defs["EPICS_PVA_TCP_SEGMENT_SIZE"] = SB()<<tcpSegmentSize;
+    defs["EPICS_PVA_TCP_RESERVE_MAX"] = SB()<<tcpReserveMax;
+    defs["EPICS_PVA_CREATE_BATCH"] = SB()<<createBatch;
 }
 
 void Config::expand()
@@ -645,6 +826,17 @@ void Config::expand()
     printAddresses(addressList, addrs);
 
     enforceTimeout(tcpTimeout);
+
+    enforceTcpWorkers(tcpWorkers);
+
+    enforceSegmentSize(tcpSegmentSize);
+
+    enforceReserveMax(tcpReserveMax);
+
+    if(createBatch==0u)
+        createBatch = 1u;
+    else if(createBatch > 0xffff)
+        createBatch = 0xffff;
 }
 
 std::ostream& operator<<(std::ostream& strm, const Config& conf)
@@ -5,6 +5,7 @@
  */
 
 #include <limits>
+#include <algorithm>
 
 #include <epicsAssert.h>
 
@@ -26,6 +27,31 @@ namespace impl {
 static
 constexpr size_t tcp_readahead_mult = 2u;
 
+// Message bodies of at least this size are received into a single
+// contiguous evbuffer chain, which allows large arrays to be decoded
+// without copying.  cf. EvInBuf::adopt()
+static
+constexpr size_t tcp_contiguous_min = 64u*1024u;
+
+// Move a partially received message (usually only the header) into a single chain
+// with enough space to receive the remainder of the message.
+static
+void rxReserve(evbuffer* rx, size_t total)
+{
+    auto n = evbuffer_get_length(rx);
+    evbuf prefix(__FILE__, __LINE__, evbuffer_new());
+
+    // bufferevent only unfreezes the end of its input buffer while reading from the socket
+    (void)evbuffer_unfreeze(rx, 0);
+    bool ok = evbuffer_remove_buffer(rx, prefix.get(), n)==int(n)
+            && !evbuffer_expand(rx, total)
+            && !evbuffer_add(rx, evbuffer_pullup(prefix.get(), -1), n);
+    (void)evbuffer_freeze(rx, 0);
+
+    if(!ok)
+        throw BAD_ALLOC();
+}
+
 ConnBase::ConnBase(bool isClient, bool sendBE, bufferevent* bev, const SockAddr& peerAddr)
     :peerAddr(peerAddr)
     ,peerName(peerAddr.tostring())
@@ -39,6 +65,11 @@ ConnBase::ConnBase(bool isClient, bool sendBE, bufferevent* bev, const SockAddr&
     ,txBody(__FILE__, __LINE__, evbuffer_new())
     ,state(Holdoff)
 {
+    // arrays decoded from segBuf may hold references to its chains,
+    // which may be released from any thread.
+    if(evbuffer_enable_locking(segBuf.get(), nullptr))
+        throw BAD_ALLOC();
+
     if(bev) // true for server connection.  client will call connect() shortly
         connect(bev);
 }
@@ -80,6 +111,9 @@ void ConnBase::connect(bufferevent* bev)
 
 void ConnBase::disconnect()
 {
+    if(txFlushTimer)
+        (void)event_del(txFlushTimer.get());
+    txCorked = false;
     bev.reset();
     state = Disconnected;
 }
@@ -88,14 +122,84 @@ size_t ConnBase::enqueueTxBody(pva_app_msg_t cmd)
 {
     auto blen = evbuffer_get_length(txBody.get());
     auto tx = bufferevent_get_output(bev.get());
-    to_evbuf(tx, Header{cmd,
-                        uint8_t(isClient ? 0u : pva_flags::Server),
-                        uint32_t(blen)},
-             sendBE);
-    auto err = evbuffer_add_buffer(tx, txBody.get());
-    assert(!err); // could only fail if frozen/pinned, which is not the case
-    statTx += 8u + blen;
-    return 8u + blen;
+    const uint8_t flags = isClient ? 0u : pva_flags::Server;
+
+    if(!txSegment || blen <= txSegment) {
+        to_evbuf(tx, Header{cmd, flags, uint32_t(blen)}, sendBE);
+        auto err = evbuffer_add_buffer(tx, txBody.get());
+        assert(!err); // could only fail if frozen/pinned, which is not the case
+        statTx += 8u + blen;
+        corkTx(1u, 8u + blen);
+        return 8u + blen;
+    }
+
+    // All segments are queued together, as a segmented message
+    // may not be interleaved with any other application message.
+    size_t total = 0u, nseg = 0u;
+    for(size_t off = 0u; off < blen; nseg++) {
+        auto slen = std::min(txSegment, blen - off);
+        uint8_t seg = off==0u ? pva_flags::SegFirst
+                              : off + slen==blen ? pva_flags::SegLast
+                                                 : pva_flags::SegMask; // middle
+
+        to_evbuf(tx, Header{cmd, uint8_t(flags | seg), uint32_t(slen)}, sendBE);
+        auto n = evbuffer_remove_buffer(txBody.get(), tx, slen);
+        assert(n==int(slen)); // could only fail if frozen/pinned, which is not the case
+        (void)n;
+        off += slen;
+        total += 8u + slen;
+    }
+    statTx += total;
+    corkTx(nseg, total);
+    return total;
+}
+
+void ConnBase::corkTx(size_t nmsg, size_t nbytes)
+{
+    if(!txFlushTimer || !bev)
+        return;
+
+    txCorkedMsg += nmsg;
+    txCorkedBytes += nbytes;
+
+    if(evbuffer_get_length(bufferevent_get_output(bev.get())) >= txFlushBytes) {
+        flushTx();
+
+    } else if(!txCorked) {
+        // hold back until the timer expires
+        if(bufferevent_disable(bev.get(), EV_WRITE) || event_add(txFlushTimer.get(), &txFlushDelay)) {
+            log_warn_printf(connio, "%s unable to cork TX\n", peerName.c_str());
+            (void)bufferevent_enable(bev.get(), EV_WRITE);
+            txCorkedMsg = txCorkedBytes = 0u;
+        } else {
+            txCorked = true;
+        }
+    }
+}
+
+void ConnBase::flushTx()
+{
+    if(txCorked && bev) {
+        (void)event_del(txFlushTimer.get());
+        statFlush++;
+        statFlushMsg += txCorkedMsg;
+        statFlushBytes += txCorkedBytes;
+
+        if(bufferevent_enable(bev.get(), EV_WRITE))
+            log_err_printf(connio, "%s unable to uncork TX\n", peerName.c_str());
+    }
+    txCorked = false;
+    txCorkedMsg = txCorkedBytes = 0u;
+}
+
+void ConnBase::flushTxS(evutil_socket_t sock, short evt, void *ptr)
+{
+    auto conn = static_cast<ConnBase*>(ptr);
+    try {
+        conn->flushTx();
+    }catch(std::exception& e){
+        log_exc_printf(connio, "Unhandled error in TX flush callback : %s\n", e.what());
+    }
 }
 
 #define CASE(Op) void ConnBase::handle_##Op() {}
@@ -121,6 +225,8 @@ size_t ConnBase::enqueueTxBody(pva_app_msg_t cmd)
     CASE(MESSAGE);
 #undef CASE
 
+void ConnBase::handle_partial() {}
+
 void ConnBase::bevEvent(short events)
 {
     if(events&(BEV_EVENT_EOF|BEV_EVENT_ERROR|BEV_EVENT_TIMEOUT)) {
@@ -203,10 +309,21 @@ void ConnBase::bevRead()
 
         if(remaining-8 < len) {
             // wait for complete payload
-            // and some additional if available
             size_t newmax = 8 + len;
-            if(newmax < std::numeric_limits<size_t>::max()-readahead)
+            if(len >= tcp_contiguous_min && len <= rxReserveMax) {
+                // receive the remainder into a single chain, which will be moved
+                // into segBuf intact.  No readahead, so that this chain will
+                // not also contain a part of the following message.
+                // Longer bodies are received incrementally, so a header alone
+                // can not cause more than rxReserveMax to be allocated.
+                rxReserve(rx, newmax);
+                bufferevent_setwatermark(bev.get(), EV_READ, newmax, newmax);
+                return;
+
+            } else if(newmax < std::numeric_limits<size_t>::max()-readahead) {
+                // and some additional if available
                 newmax += readahead;
+            }
             bufferevent_setwatermark(bev.get(), EV_READ, 8 + len, newmax);
             return;
         }
@@ -219,9 +336,9 @@ void ConnBase::bevRead()
         remaining -= 8u + len;
         statRx += 8u + len;
 
-        // so far we do not use segmentation to support incremental processing
-        // of long messages.  We instead accumulate all segments of a message
-        // prior to parsing.
+        // Segments of a message are accumulated in segBuf.  A sub-class may
+        // begin processing, and consuming, a message before the last
+        // segment arrives.  cf. handle_partial()
 
         auto seg = header[2]&pva_flags::SegMask;
 
@@ -286,6 +403,18 @@ void ConnBase::bevRead()
             if(auto n = evbuffer_get_length(segBuf.get()))
                 evbuffer_drain(segBuf.get(), n);
 
+        } else {
+            // first or middle segment
+            try {
+                handle_partial();
+            }catch(std::exception& e){
+                log_exc_printf(connio, "%s Error while processing partial cmd 0x%02x%s: %s\n",
+                               peerLabel(), segCmd, rxRegistryDirty ? " cache may be dirty" : "" ,
+                               e.what());
+                bev.reset();
+            }
+            if(!bev)
+                break;
         }
     }
 
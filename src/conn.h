@@ -42,6 +42,21 @@ public:
 
     size_t statTx{}, statRx{};
     size_t readahead{};
+    // maximum body size of transmitted segments.  zero to disable
+    size_t txSegment{};
+    // maximum body size for which RX space is reserved in advance
+    size_t rxReserveMax{};
+
+    // When txFlushTimer is set, TX is held back ("corked") after enqueueTxBody()
+    // until txFlushDelay expires, or txFlushBytes are queued.
+    evevent txFlushTimer;
+    timeval txFlushDelay{};
+    size_t txFlushBytes{};
+    bool txCorked = false;
+    // messages, and bytes, enqueued since TX was corked
+    size_t txCorkedMsg{}, txCorkedBytes{};
+    // number of flushes of corked TX, and number of messages and bytes so sent
+    size_t statFlush{}, statFlushMsg{}, statFlushBytes{};
 
     enum {
         Holdoff,
@@ -58,6 +73,8 @@ public:
     const char* peerLabel() const;
 
     size_t enqueueTxBody(pva_app_msg_t cmd);
+    // send any corked TX
+    void flushTx();
 
     bufferevent* connection() { return bev.get(); }
 
@@ -88,6 +105,10 @@ protected:
     CASE(MESSAGE);
 #undef CASE
 
+    // Called after each segment of segBuf, except the last, has been received.
+    // segCmd is the command being received.  May consume some of segBuf.
+    virtual void handle_partial();
+
     virtual std::shared_ptr<ConnBase> self_from_this() =0;
     virtual void cleanup() =0;
     virtual void bevEvent(short events);
@@ -96,6 +117,9 @@ protected:
     static void bevEventS(struct bufferevent *bev, short events, void *ptr);
     static void bevReadS(struct bufferevent *bev, void *ptr);
     static void bevWriteS(struct bufferevent *bev, void *ptr);
+    static void flushTxS(evutil_socket_t sock, short evt, void *ptr);
+private:
+    void corkTx(size_t nmsg, size_t nbytes);
 };
 
 } // namespace impl
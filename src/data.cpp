@@ -5,13 +5,19 @@
  */
 
 #include <cstring>
+#include <algorithm>
+#include <atomic>
 #include <epicsAssert.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
 
 #include "dataimpl.h"
 #include "utilpvt.h"
 
 namespace pvxs {
 
+typedef epicsGuard<epicsMutex> Guard;
+
 DEFINE_INST_COUNTER(StructTop);
 
 NoField::NoField()
@@ -825,12 +831,11 @@ void Value::traverse(const std::string &expr, bool modify, bool dothrow)
             }
 
             size_t sep = expr.find_first_of("<[-", pos);
+            const size_t len = std::min(sep, expr.size()) - pos;
 
             decltype (desc->mlookup)::const_iterator it;
 
-            const auto& name = expr.substr(pos, sep-pos);
-
-            if(sep>0 && (it=desc->mlookup.find(name))!=desc->mlookup.end()) {
+            if(sep>0 && (it=desc->mlookup.find(expr.data()+pos, len))!=desc->mlookup.end()) {
                 // found it
                 auto next = desc+it->second;
                 decltype(store) value(store, store.get()+it->second);
@@ -843,6 +848,7 @@ void Value::traverse(const std::string &expr, bool modify, bool dothrow)
                 store.reset();
                 desc = nullptr;
                 if(dothrow) {
+                    const auto name(expr.substr(pos, len));
                     SB msg;
                     msg<<"no such member field '"<<name<<"'";
                     if(name!=expr)
@@ -871,7 +877,7 @@ void Value::traverse(const std::string &expr, bool modify, bool dothrow)
                     decltype (desc->mlookup)::const_iterator it;
                     auto& fld = store->as<Value>();
 
-                    if(sep>0 && (it=desc->mlookup.find(expr.substr(pos, sep-pos)))!=desc->mlookup.end()) {
+                    if(sep>0 && (it=desc->mlookup.find(expr.data()+pos, std::min(sep, expr.size())-pos))!=desc->mlookup.end()) {
                         // found it.
 
                         if(modify || fld.desc==&desc->members[it->second]) {
@@ -990,6 +996,114 @@ const Value Value::lookup(const std::string& name) const
     return ret;
 }
 
+Value Value::operator[](const FieldPath& path)
+{
+    if(path.type && desc==path.base) {
+        Value ret;
+        ret.store = decltype(store)(store, store.get()+path.offset);
+        ret.desc = desc+path.offset;
+        return ret;
+    }
+    return (*this)[path._expr];
+}
+
+const Value Value::operator[](const FieldPath& path) const
+{
+    if(path.type && desc==path.base) {
+        Value ret;
+        ret.store = decltype(store)(store, store.get()+path.offset);
+        ret.desc = desc+path.offset;
+        return ret;
+    }
+    return (*this)[path._expr];
+}
+
+Value Value::lookup(const FieldPath& path)
+{
+    if(path.type && desc==path.base)
+        return (*this)[path];
+    return lookup(path._expr);
+}
+
+const Value Value::lookup(const FieldPath& path) const
+{
+    if(path.type && desc==path.base)
+        return (*this)[path];
+    return lookup(path._expr);
+}
+
+FieldPath::FieldPath(const Value& prototype, const std::string& expr)
+    :_expr(expr)
+{
+    auto target(prototype[expr]);
+    if(!target) {
+        // maybe through an unselected Union.  Retry with a scratch copy which may be modified.
+        // May throw.  Otherwise will not be fixed as target is not in the same StructTop.
+        target = prototype.cloneEmpty().lookup(expr);
+    }
+
+    // a fixed offset only when the target is within the same StructTop.
+    // Not after traversing a Union, Any, or array of Struct.
+    if(target.store->top==prototype.store->top) {
+        offset = target.desc - prototype.desc;
+        assert(target.store.get() - prototype.store.get()==offset);
+        base = prototype.desc;
+        type = prototype.store->top->desc;
+    }
+}
+
+struct ValuePool::Pvt {
+    const Value prototype;
+    const size_t limit;
+    epicsMutex lock;
+    std::vector<Value> pool;
+    size_t next = 0u; // pool index at which to begin search for a free entry
+
+    Pvt(const Value& prototype, size_t limit) :prototype(prototype), limit(limit) {}
+};
+
+ValuePool::ValuePool(const Value& prototype, size_t limit)
+    :pvt(std::make_shared<Pvt>(prototype.cloneEmpty(), limit))
+{
+    pvt->pool.reserve(limit);
+}
+
+Value ValuePool::create() const
+{
+    if(!pvt)
+        return Value();
+
+    auto& fl = *pvt;
+    Guard G(fl.lock);
+
+    for(size_t n=0u, N=fl.pool.size(); n<N; n++) {
+        auto idx = (fl.next + n) % N;
+        if(fl.pool[idx].store.use_count()==1) {
+            // the last user reference was released by some other thread.
+            // pairs with the release ordering of the shared_ptr decrement
+            std::atomic_thread_fence(std::memory_order_acquire);
+            fl.next = (idx + 1u) % N;
+            fl.pool[idx].clear();
+            return fl.pool[idx]; // copy shares storage
+        }
+    }
+
+    auto data(fl.prototype.cloneEmpty());
+    if(fl.pool.size() < fl.limit) {
+        fl.pool.push_back(data);
+        fl.next = 0u; // oldest entries are most likely to be released first
+    }
+    return data;
+}
+
+size_t ValuePool::size() const
+{
+    if(!pvt)
+        return 0u;
+    Guard G(pvt->lock);
+    return pvt->pool.size();
+}
+
 size_t Value::nmembers() const
 {
     switch(desc ? desc->code.code : TypeCode::Null) {
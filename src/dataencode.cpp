@@ -171,16 +171,17 @@ void from_wire(Buffer& buf, std::vector<FieldDesc>& descs, TypeStore& cache, uns
 
                 // update field refs.
                 fld.miter.emplace_back(name, cindex-cref);
-                fld.mlookup[name] = cindex-cref;
+                fld.mlookup.insert(name, cindex-cref);
                 name+='.';
 
                 if(code.code==TypeCode::Struct && code==cfld.code) {
                     // copy descendant indices for sub-struct
                     for(auto& pair : cfld.mlookup) {
-                        fld.mlookup[name+pair.first] = cindex - cref + pair.second;
+                        fld.mlookup.insert(name+pair.first, cindex - cref + pair.second);
                     }
                 }
             }
+            descs[index].mlookup.finalize();
         }
             break;
         default:
@@ -447,6 +448,40 @@ T from_wire_as(Buffer& buf)
 }
 }
 
+// decode Union selector, or Any type description, and build the (empty) member Value.
+// member is left empty for a NULL Union or Any.
+static
+void from_wire_member(Buffer& buf, TypeStore& ctxt, const FieldDesc* desc, const std::shared_ptr<FieldStorage>& store,
+                      Value& member)
+{
+    member = Value();
+
+    if(desc->code==TypeCode::Union) {
+        Selector select{};
+        from_wire(buf, select);
+        if(select.isnull()) {
+            // NULL
+
+        } else if(select.index() < desc->miter.size()) {
+            std::shared_ptr<const FieldDesc> stype(store->top->desc,
+                                                   &desc->members[desc->miter[select.index()].second]); // alias
+            member = Value::Helper::build(stype, store, desc);
+
+        } else { // invalid selection
+            buf.fault(__FILE__, __LINE__);
+        }
+
+    } else { // Any
+        auto descs(std::make_shared<std::vector<FieldDesc>>());
+
+        from_wire(buf, *descs, ctxt);
+        if(buf.good() && !descs->empty()) {
+            std::shared_ptr<const FieldDesc> stype(descs, descs->data()); // alias
+            member = Value::Helper::build(stype);
+        }
+    }
+}
+
 static
 void from_wire_field(Buffer& buf, TypeStore& ctxt,  const FieldDesc* desc, const std::shared_ptr<FieldStorage>& store)
 {
@@ -518,48 +553,12 @@ void from_wire_field(Buffer& buf, TypeStore& ctxt,  const FieldDesc* desc, const
     case StoreType::Compound: {
         auto& fld = store->as<Value>();
         switch (desc->code.code) {
-        case TypeCode::Union: {
-            Selector select{};
-            from_wire(buf, select);
-            if(select.isnull()) {
-                fld = Value();
-                return;
-
-            } else if(select.index() < desc->miter.size()) {
-                std::shared_ptr<const FieldDesc> stype(store->top->desc,
-                                                       &desc->members[desc->miter[select.index()].second]); // alias
-                fld = Value::Helper::build(stype, store, desc);
-
-                from_wire_full(buf, ctxt, fld);
-                return;
-
-            } else { // invalid selection
-                buf.fault(__FILE__, __LINE__);
-            }
-        }
-            break;
-
-        case TypeCode::Any: {
-            auto descs(std::make_shared<std::vector<FieldDesc>>());
-
-            from_wire(buf, *descs, ctxt);
-            if(!buf.good())
-                return;
-
-            if(descs->empty()) {
-                fld = Value();
-                return;
-
-            } else {
-                std::shared_ptr<const FieldDesc> stype(descs, descs->data()); // alias
-                fld = Value::Helper::build(stype);
-
+        case TypeCode::Union:
+        case TypeCode::Any:
+            from_wire_member(buf, ctxt, desc, store, fld);
+            if(buf.good() && fld)
                 from_wire_full(buf, ctxt, fld);
-                return;
-
-            }
-        }
-            break;
+            return;
 
         default: break;
         }
@@ -726,6 +725,239 @@ void from_wire_valid(Buffer& buf, TypeStore& ctxt, Value& val)
     }
 }
 
+ValidDecoder::ValidDecoder(TypeStore& ctxt, const Value& val)
+    :ctxt(ctxt)
+    ,val(val)
+    ,desc(Value::Helper::desc(val))
+    ,store(Value::Helper::store(this->val))
+{
+    if(!desc || !store)
+        fault(__FILE__, __LINE__);
+}
+
+ValidDecoder::~ValidDecoder() {}
+
+void ValidDecoder::fault(const char *fname, int lineno)
+{
+    if(!err) {
+        err = fname;
+        errline = lineno;
+    }
+}
+
+// Decode one item which must be contiguous.  Starting with what is already contiguous,
+// input is pulled up as the item requires.  If the input is incomplete,
+// the item will be decoded again from the beginning with more input.
+template<typename FN>
+bool ValidDecoder::atomic(evbuffer* buf, bool be, bool last, FN&& fn)
+{
+    auto avail = evbuffer_get_length(buf);
+    if(!last && avail < retryAt)
+        return false;
+
+    size_t want = 64u;
+    {
+        evbuffer_iovec vec;
+        if(evbuffer_peek(buf, -1, nullptr, &vec, 1)==1 && vec.iov_len > want)
+            want = vec.iov_len;
+    }
+
+    while(true) {
+        want = std::min(want, avail);
+
+        uint8_t* ptr = nullptr;
+        if(want && !(ptr = evbuffer_pullup(buf, want)))
+            throw BAD_ALLOC();
+
+        FixedBuf M(be, ptr, want);
+        fn(M);
+
+        if(M.good()) {
+            if(evbuffer_drain(buf, want - M.size()))
+                throw BAD_ALLOC();
+            retryAt = 0u;
+            return true;
+
+        } else if(want < avail) {
+            // item may extend beyond what was pulled up
+            want *= 2u;
+
+        } else if(last) {
+            fault(M.file(), M.line());
+            return false;
+
+        } else {
+            // Wait for significantly more input before re-trying, to bound
+            // the cost of repeatedly attempting to decode a large field.
+            retryAt = 2u*avail + 1u;
+            return false;
+        }
+    }
+}
+
+// Copy as much of the current array as is available
+bool ValidDecoder::fill(evbuffer* buf, bool be, bool last)
+{
+    auto dest = static_cast<char*>(arr.data());
+    const auto nbytes = arr.size()*esize;
+
+    while(filled < nbytes) {
+        if(evbuffer_get_length(buf) < esize) {
+            if(last)
+                fault(__FILE__, __LINE__);
+            return false;
+        }
+
+        evbuffer_iovec vec;
+        if(evbuffer_peek(buf, -1, nullptr, &vec, 1)!=1)
+            throw std::logic_error("evbuffer_peek() inconsistent");
+
+        if(vec.iov_len < esize) {
+            // an element spans segments
+            if(!(vec.iov_base = evbuffer_pullup(buf, esize)))
+                throw BAD_ALLOC();
+            vec.iov_len = esize;
+        }
+
+        // rounds down to element size.  requires esize be a power of 2
+        size_t n = std::min(vec.iov_len, nbytes - filled)&~(esize-1u);
+
+        if(be==hostBE) {
+            memcpy(dest + filled, vec.iov_base, n);
+        } else {
+            bswap_copy(dest + filled, vec.iov_base, n/esize, esize);
+        }
+
+        if(evbuffer_drain(buf, n))
+            throw BAD_ALLOC();
+        filled += n;
+    }
+    return true;
+}
+
+bool ValidDecoder::decode(evbuffer* buf, bool be, bool last)
+{
+    while(!err && stage!=Done) {
+        switch(stage) {
+        case Mask: {
+            BitMask valid;
+            if(!atomic(buf, be, last, [&valid](Buffer& M) {
+                       from_wire(M, valid);
+                   }))
+                break;
+
+            // encoding rounds # of bits to whole bytes, so we may trim
+            valid.resize(store->top->members.size());
+
+            // flatten sub-structures, as from_wire_field() would decode them
+            for(auto bit = valid.findSet(0u);
+                bit<desc->size();)
+            {
+                auto cdesc = desc + bit;
+                if(cdesc->code==TypeCode::Struct) {
+                    structs.push_back(bit);
+                    for(auto off : range(size_t(1u), cdesc->size())) {
+                        if(cdesc[off].code!=TypeCode::Struct)
+                            leaves.push_back(bit + off);
+                    }
+                } else {
+                    leaves.push_back(bit);
+                }
+                bit = valid.findSet(bit + cdesc->size());
+            }
+            stage = Fields;
+        }
+            continue;
+
+        case Fields: {
+            if(next==leaves.size()) {
+                for(auto bit : structs)
+                    store.get()[bit].valid = true;
+                stage = Done;
+                continue;
+            }
+
+            auto cdesc = desc + leaves[next];
+            std::shared_ptr<FieldStorage> cstore(store, store.get() + leaves[next]);
+
+            if(cdesc->code==TypeCode::Union || cdesc->code==TypeCode::Any) {
+                // decode selection, then the selected member as if it were the field
+                Value member;
+                if(!atomic(buf, be, last, [this, cdesc, &cstore, &member](Buffer& M) {
+                           from_wire_member(M, ctxt, cdesc, cstore, member);
+                       }))
+                    break;
+
+                cstore->as<Value>() = member;
+                if(!member) {
+                    cstore->valid = true;
+                    next++;
+                    continue;
+                }
+                mdesc = Value::Helper::desc(member);
+                mstore = Value::Helper::store(member);
+
+            } else {
+                mdesc = cdesc;
+                mstore = std::move(cstore);
+            }
+            stage = Member;
+        }
+            continue;
+
+        case Member: {
+            if(mstore->code==StoreType::Array && mdesc->code.kind()!=Kind::Compound
+                    && mdesc->code!=TypeCode::BoolA && mdesc->code!=TypeCode::StringA)
+            {
+                // fixed size elements.  Fill incrementally
+                Size slen{};
+                if(!atomic(buf, be, last, [&slen](Buffer& M) {
+                           from_wire(M, slen);
+                       }))
+                    break;
+
+                auto atype = mdesc->code.arrayType();
+                esize = elementSize(atype);
+                arr = allocArray(atype, slen.size);
+                filled = 0u;
+                stage = Array;
+
+            } else {
+                if(!atomic(buf, be, last, [this](Buffer& M) {
+                           from_wire_field(M, ctxt, mdesc, mstore);
+                       }))
+                    break;
+
+                store.get()[leaves[next]].valid = true;
+                mstore.reset();
+                next++;
+                stage = Fields;
+            }
+        }
+            continue;
+
+        case Array: {
+            if(!fill(buf, be, last))
+                break;
+
+            mstore->as<shared_array<const void>>() = arr.freeze();
+            store.get()[leaves[next]].valid = true;
+            mstore.reset();
+            arr.clear();
+            next++;
+            stage = Fields;
+        }
+            continue;
+
+        case Done:
+            continue;
+        }
+        break; // need more input
+    }
+
+    return err || stage==Done;
+}
+
 void from_wire_type(Buffer& buf, TypeStore& ctxt, Value& val)
 {
     auto descs(std::make_shared<std::vector<FieldDesc>>());
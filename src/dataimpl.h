@@ -8,12 +8,15 @@
 
 #include <string>
 #include <map>
+#include <vector>
 
 #include <pvxs/data.h>
 #include <pvxs/sharedArray.h>
 #include "bitmask.h"
 #include "utilpvt.h"
 
+struct evbuffer;
+
 namespace pvxs {
 
 struct Value::Helper {
@@ -52,6 +55,49 @@ void cache_sync(Value& cache, Value& delta);
 namespace impl {
 struct Buffer;
 
+/** Flat index of field names, iterated in order sorted by name.
+ *
+ * Filled by insert(), then sorted and hashed once by finalize().  Not modified afterwards.
+ * Entries are contiguous, without the per-node allocations of a std::map.
+ * find() probes an open addressed table of entry positions, keyed by nameHash().
+ * Storage is only allocated when not empty, so leaf fields pay for one pointer.
+ */
+class MemberIndex {
+public:
+    typedef std::pair<std::string, size_t> value_type;
+    typedef std::vector<value_type>::const_iterator const_iterator;
+private:
+    struct Pvt {
+        std::vector<value_type> entries;
+        // 0 - empty, otherwise 1 + position in entries.  size() is a power of two
+        std::vector<uint32_t> slots;
+    };
+    std::unique_ptr<Pvt> pvt;
+    static const std::vector<value_type> none;
+public:
+    MemberIndex() = default;
+    MemberIndex(const MemberIndex& o) :pvt(o.pvt ? new Pvt(*o.pvt) : nullptr) {}
+    MemberIndex(MemberIndex&&) noexcept = default;
+    MemberIndex& operator=(const MemberIndex& o) {
+        pvt.reset(o.pvt ? new Pvt(*o.pvt) : nullptr);
+        return *this;
+    }
+    MemberIndex& operator=(MemberIndex&&) noexcept = default;
+
+    // append.  Later insert() of a duplicate name replaces.
+    void insert(const std::string& name, size_t index);
+    // sort, and remove duplicates.  Required before find()
+    void finalize();
+
+    const_iterator find(const char* name, size_t len) const;
+    inline const_iterator find(const std::string& name) const { return find(name.data(), name.size()); }
+
+    inline const_iterator begin() const { return (pvt ? pvt->entries : none).begin(); }
+    inline const_iterator end() const { return (pvt ? pvt->entries : none).end(); }
+    inline size_t size() const { return pvt ? pvt->entries.size() : 0u; }
+    inline bool empty() const { return !pvt || pvt->entries.empty(); }
+};
+
 /** Describes a single field, leaf or otherwise, in a nested structure.
  *
  * FieldDesc are always stored depth first as a contiguous array,
@@ -69,7 +115,7 @@ struct FieldDesc {
     // "fld.sub.leaf" -> rel index
     // For Struct, relative to this (always >=1)
     // For Union, offset in members array (one entry will always be zero)
-    std::map<std::string, size_t> mlookup;
+    MemberIndex mlookup;
 
     // child iteration.  child# -> ("sub", rel index in enclosing vector<FieldDesc>)
     std::vector<std::pair<std::string, size_t>> miter;
@@ -184,6 +230,64 @@ void from_wire_full(Buffer& buf, TypeStore& ctxt, Value& val);
 PVXS_API
 void from_wire_valid(Buffer& buf, TypeStore& ctxt, Value& val);
 
+/** Resumable equivalent of from_wire_valid() for a message body received in segments.
+ *
+ * Each call to decode() consumes as much of the input as possible,
+ * so only an incomplete field need be buffered between segments.
+ * Arrays of fixed size elements are filled in place as they arrive,
+ * including when selected as the member of a Union or Any.
+ * Other fields, including Structures within a Union or Any, are decoded whole.
+ */
+class PVXS_API ValidDecoder {
+    TypeStore& ctxt;
+    Value val;
+    const FieldDesc* const desc;
+    const std::shared_ptr<FieldStorage> store;
+
+    enum {
+        Mask,   // expect BitMask
+        Fields, // expect next of leaves
+        Member, // expect mdesc/mstore of current leaf
+        Array,  // filling arr into mstore
+        Done,
+    } stage = Mask;
+
+    // offsets of fields to decode, and structures to mark valid
+    std::vector<size_t> leaves, structs;
+    size_t next = 0u;
+
+    // the current leaf, or the selected member of a Union/Any leaf
+    const FieldDesc* mdesc = nullptr;
+    std::shared_ptr<FieldStorage> mstore;
+
+    shared_array<void> arr;
+    size_t esize = 0u, filled = 0u;
+
+    // defer re-try of an incomplete field until at least this many bytes are available
+    size_t retryAt = 0u;
+
+    const char* err = nullptr;
+    int errline = -1;
+
+    void fault(const char *fname, int lineno);
+    template<typename FN>
+    bool atomic(evbuffer* buf, bool be, bool last, FN&& fn);
+    bool fill(evbuffer* buf, bool be, bool last);
+public:
+    ValidDecoder(TypeStore& ctxt, const Value& val);
+    ValidDecoder(const ValidDecoder&) = delete;
+    ValidDecoder& operator=(const ValidDecoder&) = delete;
+    ~ValidDecoder();
+
+    //! Consume from buf.  If !last, then running out of input only suspends decoding.
+    //! @returns true when decoding is complete, or has failed.  cf. good()
+    bool decode(evbuffer* buf, bool be, bool last);
+
+    bool good() const { return !err; }
+    const char* file() const { return err ? err : "(null)"; }
+    int line() const { return errline; }
+};
+
 //! deserialize type description and full value (a la. pvRequest)
 PVXS_API
 void from_wire_type_value(Buffer& buf, TypeStore& ctxt, Value& val);
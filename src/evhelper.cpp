@@ -48,10 +48,6 @@ DEFINE_LOGGER(logtimer, "pvxs.timer");
 DEFINE_LOGGER(logiface, "pvxs.iface");
 DEFINE_LOGGER(logsock, "pvxs.sock");
 
-namespace mdetail {
-VFunctor0::~VFunctor0() {}
-}
-
 static
 void evthread_init()
 {
@@ -121,13 +117,35 @@ struct evbase::Pvt final : public epicsThreadRunable
 
     struct Work {
         mfunction fn;
-        std::exception_ptr *result;
-        epicsEvent *notify;
-        Work(mfunction&& fn, std::exception_ptr *result, epicsEvent *notify)
-            :fn(std::move(fn)), result(result), notify(notify)
-        {}
+        std::exception_ptr *result = nullptr;
+        epicsEvent *notify = nullptr;
+        epicsUInt64 queued = 0u; // epicsMonotonicGet() when queued
     };
-    std::deque<Work> actions;
+
+    /* Bounded, lock-free, multi-producer single consumer inbox.
+     * cf. Vyukov's bounded MPMC queue.
+     * The sequence number of each slot shows whether it is free for the producer
+     * of position 'pos' (seq==pos), or ready for the consumer (seq==pos+1).
+     */
+    struct Slot {
+        std::atomic<size_t> seq;
+        Work work;
+    };
+    static constexpr size_t inboxSize = 256u; // power of 2
+    std::unique_ptr<Slot[]> inbox;
+    std::atomic<size_t> inboxHead{0u}; // next position to produce
+    size_t inboxTail = 0u;             // next position to consume.  worker only
+
+    // Fallback when inbox is full.  Guarded by lock.
+    // While set, all producers use the overflow to preserve ordering.
+    std::deque<Work> overflow;
+    std::atomic<bool> overflowing{false};
+
+    // dowork event has been added, and worker not yet begun to drain
+    std::atomic<bool> wakeup{false};
+
+    // guarded by lock
+    Stats counters;
 
     evbaseptr base;
     evevent keepalive;
@@ -136,15 +154,19 @@ struct evbase::Pvt final : public epicsThreadRunable
     epicsMutex lock;
 
     epicsThread worker;
-    bool running = true;
+    std::atomic<bool> running{true};
 
     INST_COUNTER(evbase);
 
     Pvt(const std::string& name, unsigned prio)
-        :worker(*this, name.c_str(),
+        :inbox(new Slot[inboxSize])
+        ,worker(*this, name.c_str(),
                 epicsThreadGetStackSize(epicsThreadStackBig),
                 prio)
     {
+        for(size_t i=0u; i<inboxSize; i++)
+            inbox[i].seq.store(i, std::memory_order_relaxed);
+
         threadOnce<&evthread_init>();
 
         worker.start();
@@ -158,10 +180,7 @@ struct evbase::Pvt final : public epicsThreadRunable
 
     void join()
     {
-        {
-            Guard G(lock);
-            running = false;
-        }
+        running = false;
         if(worker.isCurrentThread())
             log_crit_printf(logerr, "evbase self-joining: %s\n", worker.getNameSelf());
         if(event_base_loopexit(base.get(), nullptr))
@@ -216,29 +235,130 @@ struct evbase::Pvt final : public epicsThreadRunable
         }
     }
 
-    void doWork()
+    // from any thread
+    void enqueue(Work&& work)
     {
-        decltype (actions) todo;
-        {
+        work.queued = epicsMonotonicGet();
+
+        bool queued = false;
+        if(!overflowing.load(std::memory_order_acquire)) {
+            auto pos = inboxHead.load(std::memory_order_relaxed);
+            while(true) {
+                auto& slot = inbox[pos & (inboxSize-1u)];
+                auto seq = slot.seq.load(std::memory_order_acquire);
+                auto diff = intptr_t(seq) - intptr_t(pos);
+                if(diff==0) {
+                    if(inboxHead.compare_exchange_weak(pos, pos+1u, std::memory_order_relaxed)) {
+                        slot.work = std::move(work);
+                        slot.seq.store(pos+1u, std::memory_order_release);
+                        queued = true;
+                        break;
+                    }
+                } else if(diff<0) {
+                    break; // full
+                } else {
+                    pos = inboxHead.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        if(!queued) {
             Guard G(lock);
-            todo = std::move(actions);
+            overflowing.store(true, std::memory_order_release);
+            overflow.push_back(std::move(work));
+            counters.nOverflow++;
         }
-        for(auto& work : todo) {
-            try {
-                auto fn(std::move(work.fn));
-                fn();
-            }catch(std::exception& e){
-                if(work.result) {
-                    Guard G(lock);
-                    *work.result = std::current_exception();
-                } else {
-                    log_exc_printf(logerr, "Unhandled exception in event_base : %s : %s\n",
-                                    typeid(e).name(), e.what());
+
+        timeval now{};
+        if(!wakeup.exchange(true) && event_add(dowork.get(), &now))
+            throw std::runtime_error("Unable to wakeup evbase worker");
+    }
+
+    // on worker
+    bool dequeue(Work& work)
+    {
+        auto& slot = inbox[inboxTail & (inboxSize-1u)];
+        if(slot.seq.load(std::memory_order_acquire)!=inboxTail+1u)
+            return false;
+        work = std::move(slot.work);
+        slot.seq.store(inboxTail+inboxSize, std::memory_order_release);
+        inboxTail++;
+        return true;
+    }
+
+    // add to counters, and zero, pending stats.  depth is number executed in this wakeup
+    void flush(Stats& stats, size_t depth)
+    {
+        Guard G(lock);
+        counters.nWork += stats.nWork;
+        counters.latencyTotal += stats.latencyTotal;
+        if(counters.latencyMax < stats.latencyMax)
+            counters.latencyMax = stats.latencyMax;
+        if(counters.maxDepth < depth)
+            counters.maxDepth = depth;
+        stats = Stats{};
+    }
+
+    void execute(Work& work, Stats& stats, size_t& depth)
+    {
+        double latency = (epicsMonotonicGet() - work.queued)*1e-9;
+        depth++;
+        stats.nWork++;
+        stats.latencyTotal += latency;
+        if(stats.latencyMax < latency)
+            stats.latencyMax = latency;
+
+        try {
+            auto fn(std::move(work.fn));
+            fn();
+        }catch(std::exception& e){
+            if(work.result) {
+                Guard G(lock);
+                *work.result = std::current_exception();
+            } else {
+                log_exc_printf(logerr, "Unhandled exception in event_base : %s : %s\n",
+                                typeid(e).name(), e.what());
+            }
+        }
+        if(work.notify) {
+            // ensure call()er sees consistent counters
+            flush(stats, depth);
+            work.notify->signal();
+        }
+    }
+
+    void doWork()
+    {
+        // any enqueue() after this point will wake us again
+        wakeup.exchange(false);
+
+        Stats stats;
+        size_t depth = 0u;
+        Work work;
+        while(true) {
+            while(dequeue(work))
+                execute(work, stats, depth);
+
+            if(!overflowing.load(std::memory_order_acquire))
+                break;
+
+            decltype(overflow) todo;
+            {
+                Guard G(lock);
+                todo.swap(overflow);
+                if(todo.empty()) {
+                    overflowing.store(false, std::memory_order_release);
+                    break;
                 }
             }
-            if(work.notify)
-                work.notify->signal();
+            // anything in the inbox was queued before the overflow
+            while(dequeue(work))
+                execute(work, stats, depth);
+            for(auto& over : todo)
+                execute(over, stats, depth);
         }
+
+        flush(stats, depth);
     }
     static
     void doWorkS(evutil_socket_t sock, short evt, void *raw)
@@ -296,21 +416,15 @@ void evbase::sync() const
 
 bool evbase::_dispatch(mfunction&& fn, bool dothrow) const
 {
-    bool empty;
-    {
-        Guard G(pvt->lock);
-        if(!pvt->running) {
-            if(dothrow)
-                throw std::logic_error("Worker stopped");
-            return false;
-        }
-        empty = pvt->actions.empty();
-        pvt->actions.emplace_back(std::move(fn), nullptr, nullptr);
+    if(!pvt->running) {
+        if(dothrow)
+            throw std::logic_error("Worker stopped");
+        return false;
     }
 
-    timeval now{};
-    if(empty && event_add(pvt->dowork.get(), &now))
-        throw std::runtime_error("Unable to wakeup dispatch()");
+    Pvt::Work work;
+    work.fn = std::move(fn);
+    pvt->enqueue(std::move(work));
 
     return true;
 }
@@ -322,24 +436,20 @@ bool evbase::_call(mfunction&& fn, bool dothrow) const
         return true;
     }
 
+    if(!pvt->running) {
+        if(dothrow)
+            throw std::logic_error("Worker stopped");
+        return false;
+    }
+
     static ThreadEvent done;
 
     std::exception_ptr result;
-    bool empty;
-    {
-        Guard G(pvt->lock);
-        if(!pvt->running) {
-            if(dothrow)
-                throw std::logic_error("Worker stopped");
-            return false;
-        }
-        empty = pvt->actions.empty();
-        pvt->actions.emplace_back(std::move(fn), &result, done.get());
-    }
-
-    timeval now{};
-    if(empty && event_add(pvt->dowork.get(), &now))
-        throw std::runtime_error("Unable to wakeup call()");
+    Pvt::Work work;
+    work.fn = std::move(fn);
+    work.result = &result;
+    work.notify = done.get();
+    pvt->enqueue(std::move(work));
 
     done->wait();
     Guard G(pvt->lock);
@@ -348,6 +458,15 @@ bool evbase::_call(mfunction&& fn, bool dothrow) const
     return true;
 }
 
+evbase::Stats evbase::stats(bool reset) const
+{
+    Guard G(pvt->lock);
+    auto ret(pvt->counters);
+    if(reset)
+        pvt->counters = Stats{};
+    return ret;
+}
+
 void evbase::assertInLoop() const
 {
     if(!pvt->worker.isCurrentThread()) {
@@ -363,7 +482,6 @@ bool evbase::assertInRunningLoop() const
     if(pvt->worker.isCurrentThread())
         return true;
 
-    Guard G(pvt->lock);
     if(!pvt->running)
         return false;
 
@@ -936,6 +1054,10 @@ void from_wire(Buffer &buf, SockAddr& val)
 
 bool Buffer::refill(size_t more) { return false; }
 
+bool Buffer::splice(const shared_array<const void>& arr, const void* ptr, size_t nbytes) { return false; }
+
+bool Buffer::adopt(std::shared_ptr<const void>& holder, const uint8_t*& ptr, size_t nbytes, size_t align) { return false; }
+
 FixedBuf::~FixedBuf() {}
 
 VectorOutBuf::~VectorOutBuf() {}
@@ -985,8 +1107,60 @@ bool EvOutBuf::refill(size_t more)
     return true;
 }
 
+static
+void spliceCleanup(const void *data, size_t datalen, void *raw)
+{
+    // may be called from any thread which frees the last evbuffer chain referencing data
+    delete static_cast<shared_array<const void>*>(raw);
+}
+
+bool EvOutBuf::splice(const shared_array<const void>& arr, const void* ptr, size_t nbytes)
+{
+    // commit anything already written
+    if(!refill(0))
+        return false;
+
+    auto holder = new shared_array<const void>(arr);
+
+    if(evbuffer_add_reference(backing, ptr, nbytes, &spliceCleanup, holder)) {
+        delete holder;
+        return false;
+    }
+    return true;
+}
+
 EvInBuf::~EvInBuf() { refill(0); }
 
+bool EvInBuf::adopt(std::shared_ptr<const void>& holder, const uint8_t*& ptr, size_t nbytes, size_t align)
+{
+    // commit anything already consumed
+    if(!nbytes || !refill(0))
+        return false;
+
+    evbuffer_iovec vec;
+    // only possible if the first segment holds all nbytes
+    if(evbuffer_peek(backing, nbytes, nullptr, &vec, 1)!=1
+            || vec.iov_len < nbytes
+            || size_t(vec.iov_base)%align)
+        return false;
+
+    // the referenced chains are shared, and become read-only, until the holder is released.
+    // Fails if backing itself contains references to another evbuffer.
+    evbuf ref(__FILE__, __LINE__, evbuffer_new());
+    if(evbuffer_enable_locking(ref.get(), nullptr)
+            || evbuffer_add_buffer_reference(ref.get(), backing))
+        return false;
+
+    if(evbuffer_drain(backing, nbytes))
+        throw BAD_ALLOC();
+
+    auto raw = ref.release();
+    // may be released from any thread
+    holder.reset(vec.iov_base, [raw](const void*) { evbuffer_free(raw); });
+    ptr = static_cast<const uint8_t*>(vec.iov_base);
+    return true;
+}
+
 bool EvInBuf::refill(size_t needed)
 {
     if(err) return false;
@@ -1002,6 +1176,19 @@ bool EvInBuf::refill(size_t needed)
         // probably paranoia.  will evbuffer_get_length() ever return out of signed range?
         constexpr size_t max_req = std::numeric_limits<ev_ssize_t>::max();
 
+        evbuffer_iovec vec;
+
+        // peek at the next segment
+        auto n = evbuffer_peek(backing, -1, nullptr, &vec, 1);
+        if(n==1 && vec.iov_len >= needed) {
+            // already large enough.  Avoid pullup() which would copy
+            // the start of the following segment, breaking up large arrays.
+            // cf. adopt()
+            base = pos = (uint8_t*)vec.iov_base;
+            limit = base+vec.iov_len;
+            return true;
+        }
+
         // expand request in an attempt to reduce the number of refill()s
         // but limit to actual backing buffer length, or pullup() will error
         size_t requesting = std::min(
@@ -1017,10 +1204,8 @@ bool EvInBuf::refill(size_t needed)
             return false;
         }
 
-        evbuffer_iovec vec;
-
-        // peek at the next segment
-        auto n = evbuffer_peek(backing, -1, nullptr, &vec, 1);
+        // peek at the (expanded) next segment
+        n = evbuffer_peek(backing, -1, nullptr, &vec, 1);
         if(n<=0) { // current (2.1) impl never returns negative
             return false;
         }
@@ -10,6 +10,8 @@
 #include <sstream>
 #include <functional>
 #include <memory>
+#include <new>
+#include <type_traits>
 #include <string>
 #include <map>
 #include <set>
@@ -117,42 +119,121 @@ struct owned_ptr : public std::unique_ptr<T, D>
  * std::function<void()> fn(std::move(lambda));
  *
  * So we invent our own limited, non-copyable, version of std::function<void()>.
+ *
+ * Callables small enough, and with a non-throwing move, are stored inline
+ * without allocation.  eg. a lambda capturing a few (smart) pointers.
  */
 namespace mdetail {
-struct PVXS_API VFunctor0 {
-    VFunctor0() = default;
-    VFunctor0(VFunctor0&) = delete;
-    VFunctor0(const VFunctor0&) = delete;
-    VFunctor0& operator=(const VFunctor0&) = delete;
-    virtual ~VFunctor0() =0;
-    virtual void invoke() =0;
+union Storage {
+    void* heap;
+    // default alignment is suitable for any type of this size
+    std::aligned_storage<48u>::type local;
+};
+
+struct Ops {
+    void (*invoke)(Storage&);
+    // move construct dest from src, then destroy src
+    void (*move)(Storage& dest, Storage& src);
+    void (*destroy)(Storage&);
+    bool local;
+};
+
+template<typename Fn>
+struct LocalOps {
+    static Fn& get(Storage& S) { return *reinterpret_cast<Fn*>(&S.local); }
+    static void invoke(Storage& S) { get(S)(); }
+    static void move(Storage& D, Storage& S) {
+        new(&D.local) Fn(std::move(get(S)));
+        get(S).~Fn();
+    }
+    static void destroy(Storage& S) { get(S).~Fn(); }
+    static const Ops ops;
 };
 template<typename Fn>
-struct Functor0 final : public VFunctor0 {
-    Functor0() = default;
-    Functor0(Fn&& fn) : fn(std::move(fn)) {}
-    virtual ~Functor0() {}
+const Ops LocalOps<Fn>::ops{&invoke, &move, &destroy, true};
 
-    void invoke() override final { fn(); }
-private:
-    Fn fn;
+template<typename Fn>
+struct HeapOps {
+    static void invoke(Storage& S) { (*static_cast<Fn*>(S.heap))(); }
+    static void move(Storage& D, Storage& S) {
+        D.heap = S.heap;
+        S.heap = nullptr;
+    }
+    static void destroy(Storage& S) { delete static_cast<Fn*>(S.heap); }
+    static const Ops ops;
+};
+template<typename Fn>
+const Ops HeapOps<Fn>::ops{&invoke, &move, &destroy, false};
+
+template<typename Fn>
+struct fitsLocal {
+    static constexpr bool value = sizeof(Fn)<=sizeof(decltype(Storage::local))
+            && alignof(decltype(Storage::local))%alignof(Fn)==0u
+            && std::is_nothrow_move_constructible<Fn>::value;
 };
-} // namespace detail
+} // namespace mdetail
 
 struct mfunction {
     mfunction() = default;
-    template<typename Fn>
+    template<typename Fn,
+             typename FnT = typename std::decay<Fn>::type,
+             typename std::enable_if<!std::is_same<FnT, mfunction>::value, int>::type = 0>
     mfunction(Fn&& fn)
-        :fn{new mdetail::Functor0<Fn>(std::move(fn))}
-    {}
+    {
+        construct<FnT>(std::forward<Fn>(fn), std::integral_constant<bool, mdetail::fitsLocal<FnT>::value>{});
+    }
+    mfunction(mfunction&& o) noexcept
+        :ops(o.ops)
+    {
+        if(ops) {
+            ops->move(store, o.store);
+            o.ops = nullptr;
+        }
+    }
+    mfunction& operator=(mfunction&& o) noexcept {
+        if(this!=&o) {
+            reset();
+            if(o.ops) {
+                o.ops->move(store, o.store);
+                ops = o.ops;
+                o.ops = nullptr;
+            }
+        }
+        return *this;
+    }
+    mfunction(const mfunction&) = delete;
+    mfunction& operator=(const mfunction&) = delete;
+    ~mfunction() { reset(); }
+
     void operator()() const {
-        fn->invoke();
+        ops->invoke(store);
     }
     explicit operator bool() const {
-        return fn.operator bool();
+        return ops;
+    }
+    //! Was the callable stored inline, without allocation
+    bool local() const {
+        return ops && ops->local;
     }
 private:
-    std::unique_ptr<mdetail::VFunctor0> fn;
+    template<typename FnT, typename Fn>
+    void construct(Fn&& fn, std::true_type) {
+        new(&store.local) FnT(std::forward<Fn>(fn));
+        ops = &mdetail::LocalOps<FnT>::ops;
+    }
+    template<typename FnT, typename Fn>
+    void construct(Fn&& fn, std::false_type) {
+        store.heap = new FnT(std::forward<Fn>(fn));
+        ops = &mdetail::HeapOps<FnT>::ops;
+    }
+    void reset() {
+        if(ops) {
+            ops->destroy(store);
+            ops = nullptr;
+        }
+    }
+    mutable mdetail::Storage store;
+    const mdetail::Ops* ops = nullptr;
 };
 
 struct PVXS_API evbase {
@@ -198,6 +279,19 @@ public:
             return tryDispatch(std::move(fn));
     }
 
+    //! Work queue statistics
+    struct Stats {
+        //! Number of dispatch()/call() executed
+        size_t nWork = 0u;
+        //! Number queued while the lock-free inbox was full
+        size_t nOverflow = 0u;
+        //! Max. number of work executed per wakeup of the worker
+        size_t maxDepth = 0u;
+        //! Total and max. time between queuing and execution.  (seconds)
+        double latencyTotal = 0.0, latencyMax = 0.0;
+    };
+    Stats stats(bool reset=false) const;
+
     void assertInLoop() const;
     //! Caller must be on the worker, or the worker must be stopped.
     //! @returns true if working is running.
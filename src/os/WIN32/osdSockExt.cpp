@@ -134,6 +134,39 @@ int recvfromx::call()
     }
 }
 
+constexpr size_t recvmmsgx::maxBatch;
+
+int recvmmsgx::call()
+{
+    // no batch receive with winsock.  Read until the socket would block.
+    if(nmsg > maxBatch)
+        nmsg = maxBatch;
+
+    int ret = 0;
+    for(size_t i=0u; i<nmsg; i++) {
+        auto& M = msgs[i];
+        recvfromx rx{sock, M.buf, M.buflen, &M.src, &M.dst};
+        int nrx = rx.call();
+        if(nrx<0)
+            return ret ? ret : -1;
+
+        M.nrx = nrx;
+        M.dstif = rx.dstif;
+        M.ndrop = rx.ndrop;
+        ret++;
+    }
+    return ret;
+}
+
+void sendmmsgx::call()
+{
+    for(size_t i=0u; i<ndest; i++) {
+        auto& D = dests[i];
+        D.ntx = sendto(sock, (char*)buf, buflen, 0, &(*D.addr)->sa, D.addr->size());
+        D.err = D.ntx<0 ? evutil_socket_geterror(sock) : 0;
+    }
+}
+
 namespace impl {
 
 #ifndef GAA_FLAG_INCLUDE_ALL_INTERFACES
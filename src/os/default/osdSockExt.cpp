@@ -103,98 +103,223 @@ void evsocket::enable_IP_PKTINFO() const
     }
 }
 
-int recvfromx::call()
-{
-    msghdr msg{};
-
-    iovec iov = {buf, buflen};
-    msg.msg_iov = &iov;
-    msg.msg_iovlen = 1u;
-
-    msg.msg_name = &(*src)->sa;
-    msg.msg_namelen = src ? src->size() : 0u;
+namespace {
 
-    alignas (cmsghdr) char cbuf[0u
+// space for all control messages we might enable
+constexpr size_t ctrlSize = 0u
 #ifdef SO_RXQ_OVFL
-            + CMSG_SPACE(sizeof(ndrop))
+        + CMSG_SPACE(sizeof(uint32_t))
 #endif
-            // only need space for IPv4 option(s) or IPv6 option, never both.
-            + impl::cmax(0
+        // only need space for IPv4 option(s) or IPv6 option, never both.
+        + impl::cmax(0
 #ifdef IP_PKTINFO
-            + CMSG_SPACE(sizeof(in_pktinfo))
+        + CMSG_SPACE(sizeof(in_pktinfo))
 #else
 #  if defined(IP_ORIGDSTADDR)
-            + CMSG_SPACE(sizeof(sockaddr_in))
+        + CMSG_SPACE(sizeof(sockaddr_in))
 #  endif
 #  if defined(IP_RECVIF)
-            + CMSG_SPACE(sizeof(sockaddr_dl))
+        + CMSG_SPACE(sizeof(sockaddr_dl))
 #  endif
 #endif
-                  ,0
-            + CMSG_SPACE(sizeof(in6_pktinfo))
-                  ) // cmax
-            ];
-    msg.msg_control = cbuf;
-    msg.msg_controllen = sizeof(cbuf);
+              ,0
+        + CMSG_SPACE(sizeof(in6_pktinfo))
+              ); // cmax
 
+struct alignas(cmsghdr) CtrlBuf {
+    char buf[ctrlSize];
+};
+
+void parseCtrl(msghdr& msg, SockAddr* dst, int64_t& dstif, uint32_t& ndrop)
+{
     if(dst)
         *dst = SockAddr();
     dstif = -1;
     ndrop = 0u;
 
-    int ret = recvmsg(sock, &msg, 0);
-
-    if(ret>=0) { // on success, check for control messages
-        if(msg.msg_flags & MSG_CTRUNC)
-            log_warn_printf(log, "MSG_CTRUNC, expand buffer %zu <- %zu\n", size_t(msg.msg_controllen), sizeof(cbuf));
+    if(msg.msg_flags & MSG_CTRUNC)
+        log_warn_printf(log, "MSG_CTRUNC, expand buffer %zu <- %zu\n", size_t(msg.msg_controllen), ctrlSize);
 
-        for(cmsghdr *hdr = CMSG_FIRSTHDR(&msg); hdr ; hdr = CMSG_NXTHDR(&msg, hdr)) {
-            if(0) {}
+    for(cmsghdr *hdr = CMSG_FIRSTHDR(&msg); hdr ; hdr = CMSG_NXTHDR(&msg, hdr)) {
+        if(0) {}
 #ifdef SO_RXQ_OVFL
-            else if(hdr->cmsg_level==SOL_SOCKET && hdr->cmsg_type==SO_RXQ_OVFL && hdr->cmsg_len>=CMSG_LEN(sizeof(ndrop))) {
-                memcpy(&ndrop, CMSG_DATA(hdr), sizeof(ndrop));
-            }
+        else if(hdr->cmsg_level==SOL_SOCKET && hdr->cmsg_type==SO_RXQ_OVFL && hdr->cmsg_len>=CMSG_LEN(sizeof(ndrop))) {
+            memcpy(&ndrop, CMSG_DATA(hdr), sizeof(ndrop));
+        }
 #endif
 #ifdef IP_PKTINFO
-            else if(hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_PKTINFO && hdr->cmsg_len>=CMSG_LEN(sizeof(in_pktinfo))) {
-                if(dst) {
-                    (*dst)->in.sin_family = AF_INET;
-                    memcpy(&(*dst)->in.sin_addr, CMSG_DATA(hdr) + offsetof(in_pktinfo, ipi_addr), sizeof(in_addr_t));
-                }
-
-                decltype(in_pktinfo::ipi_ifindex) idx;
-                memcpy(&idx, CMSG_DATA(hdr) + offsetof(in_pktinfo, ipi_ifindex), sizeof(idx));
-                dstif = idx;
+        else if(hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_PKTINFO && hdr->cmsg_len>=CMSG_LEN(sizeof(in_pktinfo))) {
+            if(dst) {
+                (*dst)->in.sin_family = AF_INET;
+                memcpy(&(*dst)->in.sin_addr, CMSG_DATA(hdr) + offsetof(in_pktinfo, ipi_addr), sizeof(in_addr_t));
             }
 
+            decltype(in_pktinfo::ipi_ifindex) idx;
+            memcpy(&idx, CMSG_DATA(hdr) + offsetof(in_pktinfo, ipi_ifindex), sizeof(idx));
+            dstif = idx;
+        }
+
 #else
 #  ifdef IP_ORIGDSTADDR
-            else if(dst && hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_ORIGDSTADDR && hdr->cmsg_len>=CMSG_LEN(sizeof(sockaddr_in))) {
-                memcpy(&(*dst)->in, CMSG_DATA(hdr), sizeof(sockaddr_in));
-            }
+        else if(dst && hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_ORIGDSTADDR && hdr->cmsg_len>=CMSG_LEN(sizeof(sockaddr_in))) {
+            memcpy(&(*dst)->in, CMSG_DATA(hdr), sizeof(sockaddr_in));
+        }
 #  endif
 #  ifdef IP_RECVIF
-            else if(dst && hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_RECVIF && hdr->cmsg_len>=CMSG_LEN(sizeof(sockaddr_dl))) {
-                decltype (sockaddr_dl::sdl_index) idx;
-                memcpy(&idx, CMSG_DATA(hdr) + offsetof(sockaddr_dl, sdl_index), sizeof(idx));
-                dstif = idx;
-            }
+        else if(dst && hdr->cmsg_level==IPPROTO_IP && hdr->cmsg_type==IP_RECVIF && hdr->cmsg_len>=CMSG_LEN(sizeof(sockaddr_dl))) {
+            decltype (sockaddr_dl::sdl_index) idx;
+            memcpy(&idx, CMSG_DATA(hdr) + offsetof(sockaddr_dl, sdl_index), sizeof(idx));
+            dstif = idx;
+        }
 #  endif
 #endif
-            else if(hdr->cmsg_level==IPPROTO_IPV6 && hdr->cmsg_type==IPV6_PKTINFO && hdr->cmsg_len>=CMSG_LEN(sizeof(in6_pktinfo))) {
-                if(dst) {
-                    (*dst)->in6.sin6_family = AF_INET6;
-                    memcpy(&(*dst)->in6.sin6_addr, CMSG_DATA(hdr) + offsetof(in6_pktinfo, ipi6_addr), sizeof(in6_addr));
-                }
-
-                decltype(in6_pktinfo::ipi6_ifindex) idx;
-                memcpy(&idx, CMSG_DATA(hdr) + offsetof(in6_pktinfo, ipi6_ifindex), sizeof(idx));
-                dstif = idx;
+        else if(hdr->cmsg_level==IPPROTO_IPV6 && hdr->cmsg_type==IPV6_PKTINFO && hdr->cmsg_len>=CMSG_LEN(sizeof(in6_pktinfo))) {
+            if(dst) {
+                (*dst)->in6.sin6_family = AF_INET6;
+                memcpy(&(*dst)->in6.sin6_addr, CMSG_DATA(hdr) + offsetof(in6_pktinfo, ipi6_addr), sizeof(in6_addr));
             }
+
+            decltype(in6_pktinfo::ipi6_ifindex) idx;
+            memcpy(&idx, CMSG_DATA(hdr) + offsetof(in6_pktinfo, ipi6_ifindex), sizeof(idx));
+            dstif = idx;
         }
     }
+}
+
+} // namespace
+
+int recvfromx::call()
+{
+    msghdr msg{};
 
+    iovec iov = {buf, buflen};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1u;
+
+    msg.msg_name = &(*src)->sa;
+    msg.msg_namelen = src ? src->size() : 0u;
+
+    CtrlBuf cbuf;
+    msg.msg_control = cbuf.buf;
+    msg.msg_controllen = sizeof(cbuf.buf);
+
+    int ret = recvmsg(sock, &msg, 0);
+
+    if(ret>=0) { // on success, check for control messages
+        parseCtrl(msg, dst, dstif, ndrop);
+    } else {
+        if(dst)
+            *dst = SockAddr();
+        dstif = -1;
+        ndrop = 0u;
+    }
+
+    return ret;
+}
+
+constexpr size_t recvmmsgx::maxBatch;
+
+int recvmmsgx::call()
+{
+    if(nmsg > maxBatch)
+        nmsg = maxBatch;
+
+#ifdef __linux__
+    mmsghdr hdrs[maxBatch];
+    iovec iovs[maxBatch];
+    CtrlBuf cbufs[maxBatch];
+
+    for(size_t i=0u; i<nmsg; i++) {
+        auto& msg = hdrs[i].msg_hdr;
+        msg = msghdr{};
+        hdrs[i].msg_len = 0u;
+
+        iovs[i] = iovec{msgs[i].buf, msgs[i].buflen};
+        msg.msg_iov = &iovs[i];
+        msg.msg_iovlen = 1u;
+
+        msgs[i].src = SockAddr();
+        msg.msg_name = &msgs[i].src->sa;
+        msg.msg_namelen = msgs[i].src.capacity();
+
+        msg.msg_control = cbufs[i].buf;
+        msg.msg_controllen = sizeof(cbufs[i].buf);
+    }
+
+    int ret = recvmmsg(sock, hdrs, nmsg, 0, nullptr);
+
+    for(int i=0; i<ret; i++) {
+        msgs[i].nrx = hdrs[i].msg_len;
+        parseCtrl(hdrs[i].msg_hdr, &msgs[i].dst, msgs[i].dstif, msgs[i].ndrop);
+    }
+
+    return ret;
+
+#else
+    // no recvmmsg().  Read until the socket would block.
+    int ret = 0;
+    for(size_t i=0u; i<nmsg; i++) {
+        auto& M = msgs[i];
+        recvfromx rx{sock, M.buf, M.buflen, &M.src, &M.dst};
+        int nrx = rx.call();
+        if(nrx<0)
+            return ret ? ret : -1;
+
+        M.nrx = nrx;
+        M.dstif = rx.dstif;
+        M.ndrop = rx.ndrop;
+        ret++;
+    }
     return ret;
+#endif
+}
+
+void sendmmsgx::call()
+{
+#ifdef __linux__
+    mmsghdr hdrs[recvmmsgx::maxBatch];
+    iovec iov{const_cast<void*>(buf), buflen};
+
+    for(size_t base=0u; base<ndest; ) {
+        size_t nbatch = ndest-base;
+        if(nbatch > recvmmsgx::maxBatch)
+            nbatch = recvmmsgx::maxBatch;
+
+        for(size_t i=0u; i<nbatch; i++) {
+            auto& msg = hdrs[i].msg_hdr;
+            msg = msghdr{};
+            hdrs[i].msg_len = 0u;
+
+            msg.msg_iov = &iov;
+            msg.msg_iovlen = 1u;
+            msg.msg_name = const_cast<sockaddr*>(&(*dests[base+i].addr)->sa);
+            msg.msg_namelen = dests[base+i].addr->size();
+        }
+
+        int ret = sendmmsg(sock, hdrs, nbatch, 0);
+        if(ret<=0) {
+            // first message failed.  record and skip past
+            auto& D = dests[base];
+            D.ntx = -1;
+            D.err = evutil_socket_geterror(sock);
+            base++;
+
+        } else {
+            for(int i=0; i<ret; i++) {
+                dests[base+i].ntx = hdrs[i].msg_len;
+                dests[base+i].err = 0;
+            }
+            base += ret;
+        }
+    }
+
+#else
+    for(size_t i=0u; i<ndest; i++) {
+        auto& D = dests[i];
+        D.ntx = sendto(sock, (char*)buf, buflen, 0, &(*D.addr)->sa, D.addr->size());
+        D.err = D.ntx<0 ? evutil_socket_geterror(sock) : 0;
+    }
+#endif
 }
 
 namespace impl {
@@ -214,6 +214,53 @@ struct recvfromx {
     int call();
 };
 
+/** Receive several datagrams with one call.
+ *
+ *  Uses recvmmsg() where available.  Otherwise equivalent to repeated recvfromx::call()
+ *  until no more datagrams are available.
+ */
+struct recvmmsgx {
+    struct Msg {
+        void *buf;
+        size_t buflen;
+        size_t nrx;     // length of received datagram
+        SockAddr src;
+        SockAddr dst;   // if enable_IP_PKTINFO()
+        int64_t dstif;  // if enable_IP_PKTINFO(), destination interface index
+        uint32_t ndrop; // if enable_SO_RXQ_OVFL()
+    };
+    evutil_socket_t sock;
+    Msg *msgs;
+    size_t nmsg;
+
+    //! Upper limit on nmsg
+    static constexpr size_t maxBatch = 64u;
+
+    //! @returns number of datagrams received, or -1 on error (when none are received)
+    PVXS_API
+    int call();
+};
+
+/** Send one datagram to several destinations with one call.
+ *
+ *  Uses sendmmsg() where available.  Otherwise equivalent to repeated sendto().
+ */
+struct sendmmsgx {
+    struct Dest {
+        const SockAddr* addr;
+        int ntx; // result of sendto()
+        int err; // socket error when ntx<0
+    };
+    evutil_socket_t sock;
+    const void *buf;
+    size_t buflen;
+    Dest *dests;
+    size_t ndest;
+
+    PVXS_API
+    void call();
+};
+
 } // namespace pvxs
 
 #endif // OSISOCKEXT_H
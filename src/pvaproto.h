@@ -28,6 +28,29 @@ namespace pvxs {namespace impl {
 
 constexpr bool hostBE{EPICS_BYTE_ORDER==EPICS_ENDIAN_BIG};
 
+// native byte order arrays of at least this many bytes may be
+// appended, or decoded, by reference.  cf. Buffer::splice() and Buffer::adopt()
+constexpr size_t min_splice_size = 4096u;
+
+//! Byte swapping kernels for arrays of 2, 4, and 8 byte elements.
+//! Copy nelem elements from src to dest, reversing the byte order of each.
+//! src and dest need not be aligned, and must not overlap.
+struct BSwapKernel {
+    const char* name;
+    void (*swap2)(void* dest, const void* src, size_t nelem);
+    void (*swap4)(void* dest, const void* src, size_t nelem);
+    void (*swap8)(void* dest, const void* src, size_t nelem);
+};
+
+//! Kernels supported by the host CPU.  The first is the portable scalar implementation.
+//! The last is used by bswap_copy()
+PVXS_API
+const std::vector<BSwapKernel>& bswap_kernels();
+
+//! Copy nelem elements of esize bytes from src to dest, reversing the byte order of each.
+PVXS_API
+void bswap_copy(void* dest, const void* src, size_t nelem, size_t esize);
+
 //! view of a slice of a buffer.
 //! Don't use directly.  cf. FixedBuf
 struct PVXS_API Buffer {
@@ -94,6 +117,17 @@ public:
 
     uint8_t* save() const { return pos; }
     void restore(uint8_t* p) { pos = p; }
+
+    // Append [ptr, ptr+nbytes) without copying, holding a reference to arr
+    // until the bytes are no longer needed.
+    // Returns false if not supported, in which case the caller must copy.
+    virtual bool splice(const shared_array<const void>& arr, const void* ptr, size_t nbytes);
+
+    // Consume the next nbytes without copying, if they are contiguous and suitably aligned.
+    // On success, sets ptr to the first byte, and holder to a reference which keeps
+    // [ptr, ptr+nbytes) valid.
+    // Returns false if not possible, in which case nothing is consumed and the caller must copy.
+    virtual bool adopt(std::shared_ptr<const void>& holder, const uint8_t*& ptr, size_t nbytes, size_t align);
 };
 
 //! (de)serialization to/from buffers which are fixed size and contiguous
@@ -143,6 +177,7 @@ public:
     {refill(isize);}
     virtual ~EvOutBuf();
     virtual bool refill(size_t more) override final;
+    virtual bool splice(const shared_array<const void>& arr, const void* ptr, size_t nbytes) override final;
 };
 
 //! deserialize from an evbuffer, possibly segmented
@@ -161,6 +196,7 @@ public:
     virtual ~EvInBuf();
 
     virtual bool refill(size_t more) override final;
+    virtual bool adopt(std::shared_ptr<const void>& holder, const uint8_t*& ptr, size_t nbytes, size_t align) override final;
 };
 
 // assumes prior buf.ensure(M) where M>=N
@@ -482,8 +518,12 @@ void to_wire(Buffer& buf, const shared_array<const void>& varr)
         // optimize handling of types with fixed element size
 
         auto src = reinterpret_cast<const char*>(arr.data());
+        size_t nremain = arr.size()*sizeof(C);
 
-        for(size_t nremain = arr.size()*sizeof(C); nremain;) {
+        if(buf.be==hostBE && nremain>=min_splice_size && buf.good() && buf.splice(varr, src, nremain))
+            return; // large array appended w/o copy
+
+        for(; nremain;) {
             if(!buf.ensure(sizeof(C))) {
                 buf.fault(__FILE__, __LINE__);
                 break;
@@ -496,14 +536,7 @@ void to_wire(Buffer& buf, const shared_array<const void>& varr)
                 memcpy(buf.save(), src, nbytes);
 
             } else { // must swap byte order
-                auto dest = buf.save();
-
-                for(size_t i=0; i<nbytes; i+=sizeof(C)) {
-                    for(size_t n=0u; n<sizeof(C); n++) {
-                        dest[i + sizeof(C)-1-n] = src[i + n];
-
-                    }
-                }
+                bswap_copy(buf.save(), src, nbytes/sizeof(C), sizeof(C));
             }
 
             src += nbytes;
@@ -525,6 +558,21 @@ void from_wire(Buffer& buf, shared_array<const void>& varr)
 {
     Size slen{};
     from_wire(buf, slen);
+
+    if(std::is_same<E, C>::value && std::is_pod<C>::value && buf.be==hostBE && buf.good()
+            && slen.size < std::numeric_limits<size_t>::max()/sizeof(C)
+            && slen.size*sizeof(C) >= min_splice_size)
+    {
+        // already in native order.  try to reference in place
+        std::shared_ptr<const void> holder;
+        const uint8_t* ptr = nullptr;
+        if(buf.adopt(holder, ptr, slen.size*sizeof(C), alignof(E))) {
+            varr = shared_array<const E>(holder, reinterpret_cast<const E*>(ptr), slen.size)
+                    .template castTo<const void>();
+            return;
+        }
+    }
+
     shared_array<E> arr(slen.size);
 
     if(std::is_pod<C>::value) {
@@ -545,14 +593,7 @@ void from_wire(Buffer& buf, shared_array<const void>& varr)
                 memcpy(dest, buf.save(), nbytes);
 
             } else { // must swap byte order
-                auto src = buf.save();
-
-                for(size_t i=0; i<nbytes; i+=sizeof(C)) {
-                    for(size_t n=0u; n<sizeof(C); n++) {
-                        dest[i + sizeof(C)-1-n] = src[i + n];
-
-                    }
-                }
+                bswap_copy(dest, buf.save(), nbytes/sizeof(C), sizeof(C));
             }
 
             dest += nbytes;
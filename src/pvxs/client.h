@@ -231,6 +231,10 @@ public:
 
 #ifdef PVXS_EXPERT_API_ENABLED
     /** De-queue a batch of updates from subscription event queue.
+     *
+     * Values returned by the previous call are released when @p out is clear()d.
+     * If not otherwise referenced, their storage is then re-used for later updates.
+     * So a consumer which re-uses the same vector avoids allocation in steady state.
      *
      * @param out Updated with any Values dequeued.  Will always be clear()d
      * @param limit When non-zero, an upper limit on the number of Values which will be dequeued.
@@ -239,6 +243,7 @@ public:
      * @throws the same exceptions as non-batch pop()
      *
      * @since 1.1.0 Added
+     * @since UNRELEASED Storage of released Values is re-used without allocation.
      */
     inline bool pop(std::vector<Value>& out, size_t limit=0u)
     { return doPop(out, limit); }
@@ -870,6 +875,7 @@ class MonitorBuilder : public detail::CommonBuilder<MonitorBuilder, detail::Comm
     std::function<void(Subscription&)> _event;
     bool _maskConn = true;
     bool _maskDisconn = false;
+    bool _deltaOnly = false;
 public:
     MonitorBuilder() {}
     MonitorBuilder(const std::shared_ptr<Context::Pvt>& ctx, const std::string& name) :CommonBuilder{ctx,name} {}
@@ -886,6 +892,17 @@ public:
     MonitorBuilder& maskConnected(bool m = true) { _maskConn = m; return *this; }
     //! Include Disconnected exceptions in queue (default true).
     MonitorBuilder& maskDisconnected(bool m = true) { _maskDisconn = m; return *this; }
+    /** Deliver only the fields changed by each update (default false).
+     *
+     *  By default, each update is combined with the previous, so that pop() returns
+     *  a complete Value where the changed fields are marked.
+     *  With deltaOnly, unmarked fields instead hold default values (eg. zero or empty).
+     *  This avoids copying all unchanged fields of a large structure for each update.
+     *  Normally the first update is complete.
+     *
+     *  @since UNRELEASED
+     */
+    MonitorBuilder& deltaOnly(bool d = true) { _deltaOnly = d; return *this; }
 
 #ifdef PVXS_EXPERT_API_ENABLED
     // called during operation INIT phase for Get/Put/Monitor when remote type
@@ -1034,6 +1051,37 @@ struct PVXS_API Config {
     //! @since 0.2.0
     double tcpTimeout = 40.0;
 
+    //! Number of worker threads servicing TCP connections.
+    //! The single connection to each server is assigned to the least loaded worker,
+    //! which sends, receives, and decodes messages.
+    //! Search, Channel state, and user callbacks remain on one thread.
+    //! Zero or one uses a single worker.
+    //! Values over 256 are treated as 256.
+    //! @since UNRELEASED
+    unsigned tcpWorkers = 1u;
+
+    //! Maximum body size of a message sent as a single segment.
+    //! Longer messages (eg. large PUTs) are split into segments of this size.
+    //! Zero (default) disables segmentation.  Otherwise at least 1024.
+    //! @since UNRELEASED
+    size_t tcpSegmentSize = 0u;
+
+    //! Maximum body size of a received message for which buffer space is allocated in advance,
+    //! as soon as its header arrives.  Such a message is received into a single buffer,
+    //! from which large arrays may be decoded without copying.
+    //! Longer messages are still accepted, but buffered as they arrive.
+    //! Zero disables advance allocation.  Values over 4 GiB are treated as 4 GiB.
+    //! @since UNRELEASED
+    size_t tcpReserveMax = 64u*1024u*1024u;
+
+    //! Maximum number of Channels to one server created through a single CREATE_CHANNEL message.
+    //! pvxs servers accept any number, but pvAccessCPP and pvAccessJava servers
+    //! will only accept one.  So the default is one.
+    //! Values over 65535 are treated as 65535.
+    //! cf. pvxs::server::Server::clientConfig()
+    //! @since UNRELEASED
+    unsigned createBatch = 1u;
+
 private:
     bool BE = EPICS_BYTE_ORDER==EPICS_ENDIAN_BIG;
     bool UDP = true;
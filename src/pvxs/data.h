@@ -487,6 +487,8 @@ struct PVXS_API LookupError : public std::runtime_error
     virtual ~LookupError();
 };
 
+class FieldPath;
+
 /** Generic data container
  *
  * References a single data field, which may be free-standing (eg. "int x = 5;")
@@ -504,6 +506,8 @@ struct PVXS_API LookupError : public std::runtime_error
  */
 class PVXS_API Value {
     friend class TypeDef;
+    friend class FieldPath;
+    friend class ValuePool;
     // (maybe) storage for this field.  alias of StructTop::members[]
     std::shared_ptr<impl::FieldStorage> store;
     // (maybe) owned through StructTop (aliased as FieldStorage)
@@ -738,6 +742,27 @@ public:
     Value lookup(const std::string& name);
     const Value lookup(const std::string& name) const;
 
+    /** Access a descendant field through a pre-computed path.
+     *
+     * Equivalent to operator[](path.expr()).
+     * Without parsing when this Value has the type against which path was computed.
+     *
+     * @since UNRELEASED
+     */
+    Value operator[](const FieldPath& path);
+    const Value operator[](const FieldPath& path) const;
+
+    /** Access a descendant field through a pre-computed path, or throw exception.
+     *
+     * Equivalent to lookup(path.expr()).
+     *
+     * @throws LookupError If the lookup can not be satisfied
+     * @throws NoField If this Value is empty
+     * @since UNRELEASED
+     */
+    Value lookup(const FieldPath& path);
+    const Value lookup(const FieldPath& path) const;
+
     //! Number of child fields.
     //! only Struct, StructA, Union, UnionA return non-zero
     //! \since 1.1.3 correctly return non-zero for StructA and UnionA
@@ -943,6 +968,92 @@ std::ostream& operator<<(std::ostream& strm, const Value& val)
     return strm<<val.format();
 }
 
+/** Pre-computed path to a descendant field.
+ *
+ * Resolves a field expression, as accepted by Value::operator[], once
+ * against a prototype Value.  Subsequent access through a Value with the
+ * same type (eg. from prototype.cloneEmpty() ) is a pointer offset.
+ * Access through any other Value falls back to parsing the expression.
+ *
+ * Expressions which traverse a Union, Any, or array of Struct are always parsed.
+ *
+ * @code
+ * const Value prototype(nt::NTScalar{TypeCode::Float64, true}.create());
+ * const FieldPath secs(prototype, "timeStamp.secondsPastEpoch");
+ * Value val(prototype.cloneEmpty());
+ * val[secs] = 1234;
+ * @endcode
+ *
+ * @since UNRELEASED
+ */
+class PVXS_API FieldPath {
+    friend class Value;
+    // type to which 'base' belongs.  Held so that 'base' can not be re-used.
+    // NULL if expression must be parsed.
+    std::shared_ptr<const impl::FieldDesc> type;
+    const impl::FieldDesc* base = nullptr;
+    // offset from base into both FieldDesc and FieldStorage arrays
+    ptrdiff_t offset = 0;
+    std::string _expr;
+public:
+    //! Empty path.  Equivalent to expression ""
+    FieldPath() = default;
+    /** Resolve expression against prototype
+     *
+     * @throws LookupError If prototype has no field with this expression
+     * @throws NoField If prototype is empty
+     */
+    FieldPath(const Value& prototype, const std::string& expr);
+
+    //! Field expression
+    inline const std::string& expr() const { return _expr; }
+    //! Whether access through a Value of the prototype type will be a pointer offset
+    inline bool fixed() const { return !!type; }
+};
+
+/** Pool of re-usable Values of one type.
+ *
+ * create() is equivalent to prototype.cloneEmpty(), except that the storage
+ * of a Value previously returned by create() is re-used once all references to
+ * it have been released.  Creating and releasing Values of a fixed size type
+ * (eg. NTScalar) through a pool does not allocate in steady state.
+ *
+ * The pool retains at most "limit" Values.  When all retained Values are in use,
+ * create() allocates a Value which is not retained.
+ *
+ * Copies of a ValuePool share the same pool.  Methods may be called concurrently.
+ *
+ * @code
+ * ValuePool pool(nt::NTScalar{TypeCode::Float64}.create(), 16u);
+ * auto update(pool.create());
+ * update["value"] = 4.2;
+ * pv.post(update);
+ * @endcode
+ *
+ * @since UNRELEASED
+ */
+class PVXS_API ValuePool {
+    struct Pvt;
+    std::shared_ptr<Pvt> pvt;
+public:
+    //! Empty pool.  create() will return an empty Value
+    constexpr ValuePool() = default;
+    /** Pool of Values with the type of prototype
+     *
+     * @param prototype Type of created Values.  Only the type is used.
+     * @param limit Maximum number of Values retained for re-use
+     */
+    ValuePool(const Value& prototype, size_t limit);
+
+    //! Empty Value of the prototype type, with all fields unmarked.
+    Value create() const;
+
+    //! Number of Values currently retained
+    size_t size() const;
+
+    explicit operator bool() const { return !!pvt; }
+};
+
 } // namespace pvxs
 
 #endif // PVXS_DATA_H
@@ -59,12 +59,54 @@ struct Report {
         std::shared_ptr<const server::ClientCredentials> credentials;
         //! transmit and receive counters in bytes
         size_t tx{}, rx{};
+        //! Number of times held back (corked) transmissions were sent,
+        //! and the number of messages and bytes so sent.
+        //! Only from Server::report() with non-zero Config::tcpFlushDelay.
+        //! @since UNRELEASED
+        size_t nFlush{}, nFlushMsg{}, nFlushBytes{};
+        //! Number of times the worker was woken to send replies queued
+        //! from other threads (eg. by post()), and the number of replies so sent.
+        //! Only from Server::report()
+        //! @since UNRELEASED
+        size_t nReplyBatch{}, nReply{};
+        //! Index of the TCP worker thread servicing this socket.
+        //! cf. server::Config::tcpWorkers and client::Config::tcpWorkers
+        //! @since UNRELEASED
+        size_t worker{};
         //! Channels currently connected through this socket
         std::list<Channel> channels;
     };
 
     //! Currently open sockets
     std::list<Connection> connections;
+
+    //! Number of searched names offered to at least one Source (hit),
+    //! or excluded by the Source::searchFilter() of every Source (miss).
+    //! Only from Server::report()
+    //! @since UNRELEASED
+    size_t nSearchHit{}, nSearchMiss{};
+
+    //! Search statistics for a single responding server.
+    //! @since UNRELEASED
+    struct SearchPeer {
+        //! Endpoint from which search replies were received
+        std::string peer;
+        //! Smoothed search round trip time, and its variation (seconds)
+        double rtt{}, rttVar{};
+        //! Number of names found by the first search request sent,
+        //! or only after one or more retries.
+        size_t nFirst{}, nRetry{};
+    };
+
+    //! Servers which have replied to searches.  Only from Context::report()
+    //! Each client worker tracks responders separately,
+    //! so a server may appear more than once.
+    //! @since UNRELEASED
+    std::list<SearchPeer> searchPeers;
+
+    //! Number of search datagrams sent.  Only from Context::report()
+    //! @since UNRELEASED
+    size_t nSearchTx{};
 };
 
 struct PVXS_API ReportInfo {
@@ -175,6 +175,39 @@ struct PVXS_API Config {
     //! @since 0.2.0
     double tcpTimeout = 40.0;
 
+    //! Number of worker threads servicing TCP connections.
+    //! Each newly accepted connection is assigned to the worker with the fewest connections,
+    //! and is serviced entirely by that worker until closed.
+    //! Zero or one uses a single worker, which is shared with accept() and beacon transmission.
+    //! Values over 256 are treated as 256.
+    //! @since UNRELEASED
+    unsigned tcpWorkers = 1u;
+
+    //! Maximum body size of a message sent as a single segment.
+    //! Longer messages are split into segments of this size,
+    //! which a receiver may process incrementally.
+    //! Zero (default) disables segmentation.  Otherwise at least 1024.
+    //! @since UNRELEASED
+    size_t tcpSegmentSize = 0u;
+
+    //! Maximum body size of a received message for which buffer space is allocated in advance,
+    //! as soon as its header arrives.  Such a message is received into a single buffer,
+    //! from which large arrays may be decoded without copying.
+    //! Longer messages are still accepted, but buffered as they arrive.
+    //! Zero disables advance allocation.  Values over 4 GiB are treated as 4 GiB.
+    //! @since UNRELEASED
+    size_t tcpReserveMax = 64u*1024u*1024u;
+
+    //! Maximum time (microseconds) for which queued TX data may be held back,
+    //! so that several small messages (eg. monitor updates) are sent together.
+    //! Zero (default) sends without delay.
+    //! @since UNRELEASED
+    unsigned tcpFlushDelay = 0u;
+
+    //! With non-zero tcpFlushDelay, send immediately once this many bytes are queued.
+    //! @since UNRELEASED
+    size_t tcpFlushBytes = 16384u;
+
     //! Server unique ID.  Only meaningful in readback via Server::config()
     ServerGUID guid{};
 
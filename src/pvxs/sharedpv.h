@@ -80,9 +80,62 @@ struct PVXS_API SharedPV
 
     struct Impl;
 private:
+    friend struct PostBatch;
     std::shared_ptr<Impl> impl;
 };
 
+/** Collect updates for several SharedPVs to be post()ed together.
+ *
+ * commit() applies queued updates in order, as if by SharedPV::post().
+ * However, server workers are not woken until all updates have been queued.
+ * So the updates for each client connection are sent together.
+ * Several updates to the same SharedPV are merged into one.
+ *
+ * @code
+ * PostBatch batch;
+ * for(auto& pair : pvs) {
+ *     auto update(pair.second.cloneEmpty());
+ *     ...
+ *     batch.post(pair.first, update);
+ * }
+ * batch.commit();
+ * @endcode
+ *
+ * @since UNRELEASED
+ */
+struct PVXS_API PostBatch
+{
+    PostBatch();
+    ~PostBatch();
+    PostBatch(const PostBatch&) = delete;
+    PostBatch& operator=(const PostBatch&) = delete;
+
+    /** Queue an update for later commit()
+     * @throws std::logic_error if pv or val is empty.
+     */
+    PostBatch& post(const SharedPV& pv, const Value& val);
+
+    //! Number of distinct SharedPVs with queued updates
+    size_t size() const;
+    inline bool empty() const { return !size(); }
+
+    //! Discard queued updates
+    void clear();
+
+    /** Apply, and clear, all queued updates.
+     *
+     * All updates are applied, or none are.
+     *
+     * @throws std::logic_error if any SharedPV is not open(), or an update
+     *         does not have the type of its SharedPV.  Checked before any update is applied.
+     */
+    void commit();
+
+    struct Pvt;
+private:
+    std::unique_ptr<Pvt> pvt;
+};
+
 /** Allow clients to find (through a Server) SharedPV instances by name.
  *
  * A single PV name may only be added once to a StaticSource.
@@ -8,6 +8,7 @@
 
 #include <string>
 #include <functional>
+#include <memory>
 
 #include <pvxs/data.h>
 #include <pvxs/server.h>
@@ -65,6 +66,12 @@ struct MonitorStat {
     //! Number of updates squashed during post() calls
     //! @since 1.2.0
     size_t nSquash=0;
+    //! Number of updates serialized for this subscription.
+    //! @since UNRELEASED
+    size_t nEncode=0;
+    //! Number of updates sent by re-using a serialization shared with another subscription.
+    //! @since UNRELEASED
+    size_t nShared=0;
 
     bool running=false;
     bool finished=false;
@@ -133,6 +140,34 @@ public:
     virtual void onLowMark(std::function<void()>&&) =0;
 };
 
+/** Share one serialization of a Value post()'d to several subscriptions.
+ *
+ *  While in scope, MonitorControlOp::post() of this Value from the current thread
+ *  encodes it once for all subscriptions with the same field selection (pvRequest mask).
+ *  Not needed when posting to a single subscription.
+ *
+ *  @code
+ *  MonitorFanout F(update);
+ *  for(auto& sub : subscribers)
+ *      sub->post(update);
+ *  @endcode
+ *
+ *  SharedPV::post() does this automatically.
+ *
+ *  @since UNRELEASED
+ */
+class PVXS_API MonitorFanout {
+public:
+    explicit MonitorFanout(const Value& val);
+    ~MonitorFanout();
+    MonitorFanout(const MonitorFanout&) = delete;
+    MonitorFanout& operator=(const MonitorFanout&) = delete;
+
+    struct Pvt;
+private:
+    std::unique_ptr<Pvt> pvt;
+};
+
 //! Handle for subscription which is being setup
 struct PVXS_API MonitorSetupOp : public OpBase {
 protected:
@@ -196,6 +231,73 @@ private:
     virtual void _updateInfo(const std::shared_ptr<const ReportInfo>& info) =0;
 };
 
+/** Approximate set of Channel names which a Source may claim.
+ *
+ *  cf. Source::searchFilter()
+ *
+ *  A counting Bloom filter.  test() may give false positives, but never false negatives.
+ *  Memory usage is fixed by the expected number of names.
+ *  Adding many more names than expected increases the rate of false positives.
+ *
+ *  add(), remove(), and test() may be called concurrently.
+ *
+ *  @since UNRELEASED
+ */
+class PVXS_API SearchFilter {
+    struct Pvt;
+    std::unique_ptr<Pvt> pvt;
+public:
+    /** Allocate an empty filter.
+     *
+     * @param expected Anticipated number of names.  Uses 16 bytes per name.
+     * @param stop If not NULL, names are truncated at the first of these characters
+     *             before being added or tested.
+     *             eg. "." so that "record.FIELD" matches "record".
+     */
+    explicit SearchFilter(size_t expected=1024u, const char* stop=nullptr);
+    SearchFilter(const SearchFilter&) = delete;
+    SearchFilter& operator=(const SearchFilter&) = delete;
+    ~SearchFilter();
+
+    //! Add a name.  A name may be added more than once.
+    void add(const char* name);
+    inline void add(const std::string& name) { add(name.c_str()); }
+    //! Remove a name previously add()ed.
+    void remove(const char* name);
+    inline void remove(const std::string& name) { remove(name.c_str()); }
+    //! Test whether a name may have been add()ed
+    bool test(const char* name) const;
+    inline bool test(const std::string& name) const { return test(name.c_str()); }
+    /** Test with a precomputed length and hash, as from Source::Search::Name.
+     *  Hashing is only repeated when a stop character truncates the name.
+     *  @since UNRELEASED
+     */
+    bool test(const char* name, size_t len, uint64_t hash) const;
+
+    //! Number of names currently added.
+    size_t size() const;
+
+    /** Number of names for which the filter is sized.
+     *  Beyond this, test() passes an increasing fraction of names which were never added.
+     *  @since UNRELEASED
+     */
+    size_t capacity() const;
+
+    //! Called by rebuild() to add each current name
+    typedef std::function<void(const char* name)> add_fn;
+
+    /** Replace the contents of this filter with a new table sized for "expected" names.
+     *  "visit" is called once, and must call its argument with each name.
+     *  Also clears counters saturated by names which have since been remove()d.
+     *
+     *  Concurrent test() sees either the previous, or the new, contents.
+     *  Must not be called concurrently with add(), remove(), or rebuild().
+     *  Storage of the previous contents is retained until the filter is destroyed.
+     *  @since UNRELEASED
+     */
+    void rebuild(size_t expected, const std::function<void(const add_fn&)>& visit);
+};
+
 /** Interface through which a Server discovers Channel names and
  *  associates with Handler instances.
  *
@@ -219,12 +321,20 @@ struct PVXS_API Source {
         //! A single name being searched
         class Name {
             const char* _name = nullptr;
+            size_t _len = 0u;
+            uint64_t _hash = 0u;
             bool _claim = false;
             friend struct Server::Pvt;
             friend struct impl::ServerConn;
         public:
             //! The Channel name
             inline const char* name() const { return _name; }
+            //! strlen(name())
+            //! @since UNRELEASED
+            inline size_t length() const { return _len; }
+            //! 64-bit FNV-1a hash of name(), computed once for all Sources.
+            //! @since UNRELEASED
+            inline uint64_t hash() const { return _hash; }
             //! The caller claims to be able to respond to an onCreate() for this name.
             inline void claim() { _claim = true; }
             // TODO claim w/ redirect
@@ -256,6 +366,22 @@ struct PVXS_API Source {
      */
     virtual void onSearch(Search& op) =0;
 
+    /** Optional.  Describe the set of names which onSearch() might claim.
+     *
+     *  Called once from Server::addSource().
+     *  A Source which returns a SearchFilter is only offered names which pass test(),
+     *  and onSearch() is not called when no name passes.
+     *  The Source should then add() or remove() names as these are created and destroyed.
+     *
+     *  When every Source of a Server provides a SearchFilter, searches for names
+     *  which no Source could claim are rejected before any onSearch() call.
+     *
+     *  Default returns NULL, and onSearch() is offered all names.
+     *
+     *  @since UNRELEASED
+     */
+    virtual std::shared_ptr<const SearchFilter> searchFilter();
+
     /** A Client is attempting to open a connection to a certain Channel.
      *
      *  This Channel name may not be one which was seen or claimed by onSearch().
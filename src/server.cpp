@@ -7,10 +7,12 @@
 
 #include <list>
 #include <map>
+#include <algorithm>
 #include <system_error>
 #include <functional>
 #include <atomic>
 #include <cstdlib>
+#include <cstring>
 
 #include <signal.h>
 
@@ -19,6 +21,7 @@
 #include <epicsThread.h>
 #include <epicsTime.h>
 #include <epicsGuard.h>
+#include <epicsMutex.h>
 #include <epicsString.h>
 
 #include <pvxs/server.h>
@@ -36,6 +39,8 @@ ReportInfo::~ReportInfo() {}
 namespace server {
 using namespace impl;
 
+typedef epicsGuard<epicsMutex> Guard;
+
 DEFINE_LOGGER(serversetup, "pvxs.server.setup");
 DEFINE_LOGGER(serverio, "pvxs.server.io");
 DEFINE_LOGGER(serversearch, "pvxs.server.search");
@@ -85,13 +90,16 @@ Server& Server::addSource(const std::string& name,
         throw std::logic_error("NULL Server");
     if(!src)
         throw std::logic_error(SB()<<"Attempt to add NULL Source "<<name<<" at "<<order);
+    auto filter(src->searchFilter());
     {
         auto G(pvt->sourcesLock.lockWriter());
 
-        auto& ent = pvt->sources[std::make_pair(order, name)];
+        auto key(std::make_pair(order, name));
+        auto& ent = pvt->sources[key];
         if(ent)
             throw std::runtime_error(SB()<<"Source already registered : ("<<name<<", "<<order<<")");
         ent = src;
+        pvt->searchFilters[key] = filter;
         pvt->beaconChange++;
     }
     return *this;
@@ -109,6 +117,7 @@ std::shared_ptr<Source> Server::removeSource(const std::string& name,  int order
     if(it!=pvt->sources.end()) {
         ret = it->second;
         pvt->sources.erase(it);
+        pvt->searchFilters.erase(std::make_pair(order, name));
     }
     pvt->beaconChange++;
 
@@ -167,6 +176,8 @@ client::Config Server::clientConfig() const
     ret.interfaces = pvt->effective.interfaces;
     ret.addressList = pvt->effective.interfaces;
     ret.autoAddrList = false;
+    // we accept many channels per CREATE_CHANNEL
+    ret.createBatch = 1024u;
 
     return ret;
 }
@@ -240,20 +251,37 @@ Report Server::report(bool zero) const
 
     Report ret;
 
-    pvt->acceptor_loop.call([this, &ret, zero](){
+    if(zero) {
+        ret.nSearchHit = pvt->statSearchHit.exchange(0u);
+        ret.nSearchMiss = pvt->statSearchMiss.exchange(0u);
+    } else {
+        ret.nSearchHit = pvt->statSearchHit.load();
+        ret.nSearchMiss = pvt->statSearchMiss.load();
+    }
 
-        for(auto& pair : pvt->connections) {
-            auto conn = pair.first;
+    for(auto& ref : pvt->listConnections()) {
+        auto loop(ref->loop);
+        loop.call([&ref, &ret, zero](){
+            // ensure that the last reference is released on the worker
+            auto conn(std::move(ref));
 
             ret.connections.emplace_back();
             auto& sconn = ret.connections.back();
             sconn.peer = conn->peerName;
             sconn.credentials = conn->cred;
+            sconn.worker = conn->worker;
             sconn.tx = conn->statTx;
             sconn.rx = conn->statRx;
+            sconn.nFlush = conn->statFlush;
+            sconn.nFlushMsg = conn->statFlushMsg;
+            sconn.nFlushBytes = conn->statFlushBytes;
+            sconn.nReplyBatch = conn->replies->statBatch;
+            sconn.nReply = conn->replies->statReply;
 
             if(zero) {
                 conn->statTx = conn->statRx = 0u;
+                conn->statFlush = conn->statFlushMsg = conn->statFlushBytes = 0u;
+                conn->replies->statBatch = conn->replies->statReply = 0u;
             }
 
             for(auto& pair : conn->chanBySID) {
@@ -270,9 +298,8 @@ Report Server::report(bool zero) const
                     chan->statTx = chan->statRx = 0u;
                 }
             }
-        }
-
-    });
+        });
+    }
 
     return ret;
 }
@@ -321,22 +348,43 @@ std::ostream& operator<<(std::ostream& strm, const Server& serv)
                 auto& first = serv.pvt->interfaces.front();
                 strm<<" TCP_Port: "<<first.bind_addr.port();
             }
+            strm<<" TCP_Workers: "<<serv.pvt->tcp_workers.size();
+            strm<<" Search hit="<<serv.pvt->statSearchHit.load()
+                <<" miss="<<serv.pvt->statSearchMiss.load();
             strm<<"\n";
+        });
+
+        for(size_t i=0u; i<serv.pvt->tcp_workers.size(); i++) {
+            auto stats(serv.pvt->tcp_workers[i].stats());
+            strm<<indent{}<<"Worker "<<i<<" dispatch="<<stats.nWork
+                <<" overflow="<<stats.nOverflow
+                <<" maxDepth="<<stats.maxDepth
+                <<" latency avg="<<(stats.nWork ? stats.latencyTotal/stats.nWork : 0.0)
+                <<" max="<<stats.latencyMax<<" s\n";
+        }
 
-            Indented I(strm);
+        Indented I(strm);
 
-            for(auto& pair : serv.pvt->connections) {
-                auto conn = pair.first;
+        for(auto& ref : serv.pvt->listConnections()) {
+            auto loop(ref->loop);
+            loop.call([&ref, &strm, detail](){
+                // ensure that the last reference is released on the worker
+                auto conn(std::move(ref));
 
                 strm<<indent{}<<"Peer"<<conn->peerName
                     <<" backlog="<<conn->backlog.size()
                     <<" TX="<<conn->statTx<<" RX="<<conn->statRx
-                    <<" auth="<<conn->cred->method<<"\n";
+                    <<" auth="<<conn->cred->method;
+                if(conn->statFlush)
+                    strm<<" flush="<<conn->statFlush
+                        <<" msg/flush="<<double(conn->statFlushMsg)/conn->statFlush
+                        <<" bytes/flush="<<double(conn->statFlushBytes)/conn->statFlush;
+                strm<<"\n";
                 if(detail>2)
                     strm<<*conn->cred;
 
                 if(detail<=2)
-                    continue;
+                    return;
 
                 Indented I(strm);
 
@@ -371,8 +419,8 @@ std::ostream& operator<<(std::ostream& strm, const Server& serv)
                         }
                     }
                 }
-            }
-        });
+            });
+        }
     }
 
     return strm;
@@ -392,6 +440,16 @@ Server::Pvt::Pvt(const Config &conf)
 {
     effective.expand();
 
+    if(effective.tcpWorkers<=1u) {
+        tcp_workers.push_back(acceptor_loop);
+    } else {
+        tcp_workers.reserve(effective.tcpWorkers);
+        for(auto i : range(effective.tcpWorkers)) {
+            tcp_workers.emplace_back(SB()<<"PVXTCP-"<<i, epicsThreadPriorityCAServerLow-2);
+        }
+    }
+    tcp_load.resize(tcp_workers.size(), 0u);
+
     beaconSender4.set_broadcast(true);
 
     auto manager = UDPManager::instance(effective.shareUDP());
@@ -558,8 +616,14 @@ Server::Pvt::Pvt(const Config &conf)
     // Add magic "server" PV
     {
         auto L = sourcesLock.lockWriter();
-        sources[std::make_pair(-1, "__server")] = std::make_shared<ServerSource>(this);
-        sources[std::make_pair(-1, "__builtin")] = builtinsrc.source();
+        for(auto& pair : std::initializer_list<std::pair<const char*, std::shared_ptr<Source>>>{
+            {"__server", std::make_shared<ServerSource>(this)},
+            {"__builtin", builtinsrc.source()},
+        }) {
+            auto key(std::make_pair(-1, pair.first));
+            sources[key] = pair.second;
+            searchFilters[key] = pair.second->searchFilter();
+        }
     }
 }
 
@@ -649,14 +713,32 @@ void Server::Pvt::stop()
             }
             log_debug_printf(serversetup, "Server disabled listener on %s\n", iface.name.c_str());
         }
+    });
 
-        // close current TCP connections
-        auto conns = std::move(connections);
-        for(auto& pair : conns) {
-            pair.second->disconnect();
-            pair.second->cleanup();
-        }
+    // complete any connection setup queued by the acceptor
+    for(auto& worker : tcp_workers) {
+        worker.sync();
+    }
 
+    // close current TCP connections
+    decltype(connections) conns;
+    {
+        Guard G(connectionsLock);
+        conns = std::move(connections);
+        connections.clear();
+        std::fill(tcp_load.begin(), tcp_load.end(), 0u);
+    }
+    for(auto& pair : conns) {
+        auto loop(pair.second->loop);
+        loop.call([&pair](){
+            auto conn(std::move(pair.second));
+            conn->disconnect();
+            conn->cleanup();
+        });
+    }
+
+    acceptor_loop.call([this]()
+    {
         state = Stopped;
     });
 
@@ -664,9 +746,93 @@ void Server::Pvt::stop()
      * TODO: this is partly a crutch as eg. SharedPV::attach() binds strong self references
      *       into on*() lambdas, which indirectly hold references keeping acceptor_loop alive.
      */
+    for(auto& worker : tcp_workers) {
+        worker.sync();
+    }
     acceptor_loop.sync();
 }
 
+size_t Server::Pvt::pickWorker()
+{
+    Guard G(connectionsLock);
+
+    size_t best = 0u;
+    for(auto i : range(tcp_load.size())) {
+        if(tcp_load[i] < tcp_load[best])
+            best = i;
+    }
+    tcp_load[best]++;
+    return best;
+}
+
+std::vector<std::shared_ptr<ServerConn>> Server::Pvt::listConnections()
+{
+    std::vector<std::shared_ptr<ServerConn>> ret;
+
+    Guard G(connectionsLock);
+    ret.reserve(connections.size());
+    for(auto& pair : connections) {
+        ret.push_back(pair.second);
+    }
+    return ret;
+}
+
+void Server::Pvt::searchSources(Source::Search& op, SearchScratch& scratch)
+{
+    const auto nname = op._names.size();
+    scratch.offered.assign(nname, 0u);
+
+    assert(sources.size()==searchFilters.size());
+    auto filt(searchFilters.begin());
+    for(auto it(sources.begin()), end(sources.end()); it!=end; ++it, ++filt) {
+        const auto& src = it->second;
+        const auto& filter = filt->second;
+        Source::Search* target = &op;
+
+        if(filter) {
+            // offer only names which pass this Source's filter
+            auto& sub = scratch.sub;
+            sub._names.clear();
+            scratch.idx.clear();
+            for(size_t i=0u; i<nname; i++) {
+                const auto& name = op._names[i];
+                if(filter->test(name._name, name._len, name._hash)) {
+                    sub._names.push_back(name);
+                    sub._names.back()._claim = false;
+                    scratch.idx.push_back(i);
+                }
+            }
+            if(sub._names.empty())
+                continue;
+            memcpy(sub._src, op._src, sizeof(sub._src));
+            target = &sub;
+        }
+
+        try {
+            src->onSearch(*target);
+        }catch(std::exception& e){
+            log_exc_printf(serversetup, "Unhandled error in Source::onSearch for '%s' : %s\n",
+                       it->first.second.c_str(), e.what());
+        }
+
+        if(target==&op) {
+            std::fill(scratch.offered.begin(), scratch.offered.end(), 1u);
+
+        } else {
+            for(size_t i=0u; i<scratch.idx.size(); i++) {
+                auto idx = scratch.idx[i];
+                scratch.offered[idx] = 1u;
+                if(scratch.sub._names[i]._claim)
+                    op._names[idx]._claim = true;
+            }
+        }
+    }
+
+    size_t nhit = std::count(scratch.offered.begin(), scratch.offered.end(), 1u);
+    statSearchHit.fetch_add(nhit, std::memory_order_relaxed);
+    statSearchMiss.fetch_add(nname-nhit, std::memory_order_relaxed);
+}
+
 void Server::Pvt::onSearch(const UDPManager::Search& msg)
 {
     // on UDPManager worker
@@ -690,20 +856,15 @@ void Server::Pvt::onSearch(const UDPManager::Search& msg)
     searchOp._names.resize(msg.names.size());
     for(auto i : range(msg.names.size())) {
         searchOp._names[i]._name = msg.names[i].name;
+        searchOp._names[i]._len = msg.names[i].len;
+        searchOp._names[i]._hash = msg.names[i].hash;
         searchOp._names[i]._claim = false;
     }
     ipAddrToDottedIP(&msg.server->in, searchOp._src, sizeof(searchOp._src));
 
     {
         auto G(sourcesLock.lockReader());
-        for(const auto& pair : sources) {
-            try {
-                pair.second->onSearch(searchOp);
-            }catch(std::exception& e){
-                log_exc_printf(serversetup, "Unhandled error in Source::onSearch for '%s' : %s\n",
-                           pair.first.second.c_str(), e.what());
-            }
-        }
+        searchSources(searchOp, searchScratch);
     }
 
     uint16_t nreply = 0;
@@ -751,6 +912,25 @@ void Server::Pvt::onSearch(const UDPManager::Search& msg)
     }
 }
 
+static
+void logBeaconTx(const sendmmsgx::Dest& D, size_t pktlen)
+{
+    if(D.ntx<0) {
+        auto lvl = Level::Warn;
+        if(D.err==EINTR || D.err==EPERM)
+            lvl = Level::Debug;
+        log_printf(serverio, lvl, "Beacon tx error (%d) %s\n",
+                   D.err, evutil_socket_error_to_string(D.err));
+
+    } else if(unsigned(D.ntx)<pktlen) {
+        log_warn_printf(serverio, "Beacon truncated %u < %u",
+                   unsigned(D.ntx), unsigned(pktlen));
+
+    } else {
+        log_debug_printf(serverio, "Beacon tx to %s\n", D.addr->tostring().c_str());
+    }
+}
+
 void Server::Pvt::doBeacons(short evt)
 {
     log_debug_printf(serversetup, "Server beacon timer expires\n%s", "");
@@ -777,26 +957,35 @@ void Server::Pvt::doBeacons(short evt)
 
     assert(M.good() && H.good());
 
-    for(const auto& dest : beaconDest) {
-        auto& sender = dest.addr.family()==AF_INET ? beaconSender4 : beaconSender6;
-        sender.mcast_prep_sendto(dest);
+    // unicast and broadcast destinations are sent together.
+    // mcast destinations need per-destination socket options, so are sent alone.
+    for(auto af : {AF_INET, AF_INET6}) {
+        auto& sender = af==AF_INET ? beaconSender4 : beaconSender6;
+        beaconBatch.clear();
 
-        int ntx = sendto(sender.sock, (char*)beaconMsg.data(), pktlen, 0, &dest.addr->sa, dest.addr.size());
+        for(const auto& dest : beaconDest) {
+            if(dest.addr.family()!=af) {
+                continue;
 
-        if(ntx<0) {
-            int err = evutil_socket_geterror(sender.sock);
-            auto lvl = Level::Warn;
-            if(err==EINTR || err==EPERM)
-                lvl = Level::Debug;
-            log_printf(serverio, lvl, "Beacon tx error (%d) %s\n",
-                       err, evutil_socket_error_to_string(err));
+            } else if(dest.addr.isMCast()) {
+                sender.mcast_prep_sendto(dest);
 
-        } else if(unsigned(ntx)<pktlen) {
-            log_warn_printf(serverio, "Beacon truncated %u < %u",
-                       unsigned(ntx), unsigned(pktlen));
+                sendmmsgx::Dest D{&dest.addr};
+                sendmmsgx{sender.sock, beaconMsg.data(), pktlen, &D, 1u}.call();
+                logBeaconTx(D, pktlen);
 
-        } else {
-            log_debug_printf(serverio, "Beacon tx to %s\n", std::string(SB()<<dest).c_str());
+            } else {
+                beaconBatch.push_back(sendmmsgx::Dest{&dest.addr});
+            }
+        }
+
+        if(beaconBatch.empty())
+            continue;
+
+        sendmmsgx{sender.sock, beaconMsg.data(), pktlen, beaconBatch.data(), beaconBatch.size()}.call();
+
+        for(const auto& D : beaconBatch) {
+            logBeaconTx(D, pktlen);
         }
     }
 
@@ -826,6 +1015,144 @@ Source::List Source::onList() {
     return Source::List{};
 }
 
+std::shared_ptr<const SearchFilter> Source::searchFilter()
+{
+    return nullptr;
+}
+
+struct SearchFilter::Pvt {
+    struct Table {
+        // counters saturate, and then are never decremented
+        std::unique_ptr<std::atomic<uint8_t>[]> counts;
+        size_t mask;
+
+        explicit Table(size_t expected)
+        {
+            size_t ncount = 64u;
+            while(ncount < expected*16u && ncount < (size_t(1u)<<31u))
+                ncount <<= 1u;
+
+            counts.reset(new std::atomic<uint8_t>[ncount]);
+            for(size_t i=0u; i<ncount; i++)
+                counts[i].store(0u, std::memory_order_relaxed);
+            mask = ncount-1u;
+        }
+    };
+    // Current table.  Replaced by rebuild() while test() may be running.
+    std::atomic<const Table*> cur{nullptr};
+    // all tables, including those replaced, which a concurrent test() may still be using.
+    std::vector<std::unique_ptr<Table>> tables;
+    std::string stop;
+    std::atomic<size_t> nnames{0u};
+
+    static constexpr unsigned nprobe = 4u;
+
+    // hash of the (maybe truncated) name
+    uint64_t hash(const char* name) const
+    {
+        return nameHash(name, stop.empty() ? strlen(name) : strcspn(name, stop.c_str()));
+    }
+
+    // double hashing to find the counters of one name
+    template<typename Fn>
+    static
+    void probe(const Table& T, uint64_t H, Fn&& fn)
+    {
+        auto H1 = uint32_t(H), H2 = uint32_t(H>>32u) | 1u;
+        for(unsigned i=0u; i<nprobe; i++) {
+            if(!fn(T.counts[(H1 + i*H2) & T.mask]))
+                break;
+        }
+    }
+
+    static
+    void add(const Table& T, uint64_t H)
+    {
+        probe(T, H, [](std::atomic<uint8_t>& C) {
+            auto cur = C.load(std::memory_order_relaxed);
+            while(cur!=0xffu && !C.compare_exchange_weak(cur, cur+1u, std::memory_order_relaxed)) {}
+            return true;
+        });
+    }
+};
+
+SearchFilter::SearchFilter(size_t expected, const char* stop)
+    :pvt(new Pvt)
+{
+    pvt->tables.emplace_back(new Pvt::Table(expected));
+    pvt->cur.store(pvt->tables.back().get(), std::memory_order_release);
+    if(stop)
+        pvt->stop = stop;
+}
+
+SearchFilter::~SearchFilter() {}
+
+void SearchFilter::add(const char* name)
+{
+    Pvt::add(*pvt->tables.back(), pvt->hash(name));
+    pvt->nnames.fetch_add(1u, std::memory_order_relaxed);
+}
+
+void SearchFilter::remove(const char* name)
+{
+    Pvt::probe(*pvt->tables.back(), pvt->hash(name), [](std::atomic<uint8_t>& C) {
+        auto cur = C.load(std::memory_order_relaxed);
+        while(cur!=0xffu && cur!=0u && !C.compare_exchange_weak(cur, cur-1u, std::memory_order_relaxed)) {}
+        return true;
+    });
+    pvt->nnames.fetch_sub(1u, std::memory_order_relaxed);
+}
+
+bool SearchFilter::test(const char* name) const
+{
+    auto len = strlen(name);
+    return test(name, len, nameHash(name, len));
+}
+
+bool SearchFilter::test(const char* name, size_t len, uint64_t hash) const
+{
+    if(!pvt->stop.empty()) {
+        auto plen = strcspn(name, pvt->stop.c_str());
+        if(plen < len)
+            hash = nameHash(name, plen);
+    }
+
+    bool ret = true;
+    Pvt::probe(*pvt->cur.load(std::memory_order_acquire), hash, [&ret](std::atomic<uint8_t>& C) {
+        ret = C.load(std::memory_order_relaxed)!=0u;
+        return ret;
+    });
+    return ret;
+}
+
+size_t SearchFilter::size() const
+{
+    return pvt->nnames.load(std::memory_order_relaxed);
+}
+
+size_t SearchFilter::capacity() const
+{
+    return (pvt->tables.back()->mask+1u)/16u;
+}
+
+void SearchFilter::rebuild(size_t expected, const std::function<void(const add_fn&)>& visit)
+{
+    std::unique_ptr<Pvt::Table> next(new Pvt::Table(expected));
+    size_t nnames = 0u;
+    {
+        auto& T = *next;
+        visit([this, &T, &nnames](const char* name) {
+            Pvt::add(T, pvt->hash(name));
+            nnames++;
+        });
+    }
+
+    pvt->tables.push_back(std::move(next));
+    pvt->nnames.store(nnames, std::memory_order_relaxed);
+    // publish only after fully populated
+    pvt->cur.store(pvt->tables.back().get(), std::memory_order_release);
+}
+
 void Source::show(std::ostream& strm)
 {
     auto list(onList());
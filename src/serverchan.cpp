@@ -62,6 +62,7 @@ void ServerChan::cleanup()
 ServerChannelControl::ServerChannelControl(const std::shared_ptr<ServerConn> &conn, const std::shared_ptr<ServerChan>& channel)
     :server::ChannelControl(channel->name, conn->cred, None)
     ,server(conn->iface->server->internal_self)
+    ,loop(conn->loop)
     ,chan(channel)
 {}
 
@@ -73,7 +74,7 @@ void ServerChannelControl::onOp(std::function<void(std::unique_ptr<server::Conne
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &fn](){
+    loop.call([this, &fn](){
         auto ch = chan.lock();
         if(!ch)
             return;
@@ -88,7 +89,7 @@ void ServerChannelControl::onRPC(std::function<void(std::unique_ptr<server::Exec
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &fn](){
+    loop.call([this, &fn](){
         auto ch = chan.lock();
         if(!ch)
             return;
@@ -103,7 +104,7 @@ void ServerChannelControl::onSubscribe(std::function<void(std::unique_ptr<server
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &fn](){
+    loop.call([this, &fn](){
         auto ch = chan.lock();
         if(!ch)
             return;
@@ -118,7 +119,7 @@ void ServerChannelControl::onClose(std::function<void(const std::string&)>&& fn)
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &fn](){
+    loop.call([this, &fn](){
         auto ch = chan.lock();
         if(!ch || ch->state==ServerChan::Destroy)
             return;
@@ -134,7 +135,7 @@ void ServerChannelControl::close()
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this](){
+    loop.call([this](){
         auto ch = chan.lock();
         if(!ch)
             return;
@@ -162,7 +163,7 @@ void ServerChannelControl::_updateInfo(const std::shared_ptr<const ReportInfo>&
     if(!serv)
         return;
 
-    serv->acceptor_loop.call([this, &info](){
+    loop.call([this, &info](){
         auto ch = chan.lock();
         if(!ch)
             return;
@@ -204,21 +205,17 @@ void ServerConn::handle_SEARCH()
         from_wire(M, nameStorage[n].first);
         from_wire(M, nameStorage[n].second);
         op._names[n]._name = nameStorage[n].second.c_str();
+        op._names[n]._len = strlen(op._names[n]._name);
+        op._names[n]._hash = nameHash(op._names[n]._name, op._names[n]._len);
     }
 
     if(!M.good())
         throw std::runtime_error(SB()<<M.file()<<':'<<M.line()<<" TCP Search decode error");
 
     {
+        server::Server::Pvt::SearchScratch scratch;
         auto G(iface->server->sourcesLock.lockReader());
-        for(const auto& pair : iface->server->sources) {
-            try {
-                pair.second->onSearch(op);
-            }catch(std::exception& e){
-                log_exc_printf(serversearch, "Unhandled error in Source::onSearch for '%s' : %s\n",
-                           pair.first.second.c_str(), e.what());
-            }
-        }
+        iface->server->searchSources(op, scratch);
     }
 
     uint16_t nreply = 0;
@@ -263,8 +260,9 @@ void ServerConn::handle_CREATE_CHANNEL()
 
     auto G(iface->server->sourcesLock.lockReader());
 
-    // one channel create request contains main channel names.
+    // one channel create request contains many channel names.
     // each of which will received a separate reply.
+    // Replies are queued together, and sent when this handler returns.
 
     uint16_t count = 0;
     from_wire(M, count);
@@ -275,14 +273,20 @@ void ServerConn::handle_CREATE_CHANNEL()
         from_wire(M, cid);
         from_wire(M, name);
 
-        if(!M.good() || name.empty())
+        if(!M.good())
             break;
 
         Status sts{Status::Ok};
 
         bool claimed = false;
 
-        if(chanBySID.size()==0xffffffff) {
+        if(name.empty()) {
+            // refuse, and continue with any other names in this request
+            sts.code = Status::Error;
+            sts.msg = "Empty channel name";
+            sts.trace = "pvx:serv:emptychan:";
+
+        } else if(chanBySID.size()==0xffffffff) {
             sts.code = Status::Error;
             sts.msg = "Too many Server channels";
             sts.trace = "pvx:serv:chanidoverflow:";
@@ -46,6 +46,8 @@ std::ostream& operator<<(std::ostream& strm, const ClientCredentials& cred)
 
 namespace pvxs {namespace impl {
 
+typedef epicsGuard<epicsMutex> Guard;
+
 // message related to client state and errors
 DEFINE_LOGGER(connsetup, "pvxs.tcp.setup");
 // related to low level send/recv
@@ -53,11 +55,87 @@ DEFINE_LOGGER(connio, "pvxs.tcp.io");
 
 DEFINE_LOGGER(remote, "pvxs.remote.log");
 
-ServerConn::ServerConn(ServIface* iface, evutil_socket_t sock, struct sockaddr *peer, int socklen)
+namespace {
+// innermost ReplyBatch on this thread
+thread_local ReplyBatch* currentBatch;
+}
+
+ReplyBatch::ReplyBatch()
+    :outer(currentBatch)
+{
+    currentBatch = this;
+}
+
+ReplyBatch::~ReplyBatch()
+{
+    currentBatch = outer;
+    for(auto& queue : wake) {
+        try {
+            queue->wakeup();
+        }catch(std::exception& e){
+            log_exc_printf(connio, "Unable to wake worker after batch : %s\n", e.what());
+        }
+    }
+}
+
+void ReplyQueue::push(mfunction&& fn)
+{
+    bool wake;
+    {
+        Guard G(lock);
+        pending.push_back(std::move(fn));
+        wake = !scheduled;
+        scheduled = true;
+    }
+    if(!wake) {
+        // already scheduled, or deferred by some ReplyBatch
+
+    } else if(auto batch = currentBatch) {
+        while(batch->outer)
+            batch = batch->outer;
+        batch->wake.push_back(shared_from_this());
+
+    } else {
+        wakeup();
+    }
+}
+
+void ReplyQueue::wakeup()
+{
+    auto self(shared_from_this());
+    loop.dispatch([self]() {
+        self->run();
+    });
+}
+
+void ReplyQueue::run()
+{
+    {
+        Guard G(lock);
+        running.swap(pending);
+        scheduled = false;
+    }
+    statBatch++;
+    statReply += running.size();
+    for(auto& fn : running) {
+        try {
+            fn();
+        }catch(std::exception& e){
+            log_exc_printf(connio, "Unhandled exception in reply : %s : %s\n",
+                           typeid(e).name(), e.what());
+        }
+    }
+    running.clear();
+}
+
+ServerConn::ServerConn(ServIface* iface, const evbase& loop, size_t worker, evutil_socket_t sock, const SockAddr& peer)
     :ConnBase(false, iface->server->effective.sendBE(),
-              bufferevent_socket_new(iface->server->acceptor_loop.base, sock, BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS),
-              SockAddr(peer))
+              bufferevent_socket_new(loop.base, sock, BEV_OPT_CLOSE_ON_FREE|BEV_OPT_DEFER_CALLBACKS),
+              peer)
     ,iface(iface)
+    ,loop(loop)
+    ,replies(std::make_shared<ReplyQueue>(loop))
+    ,worker(worker)
     ,tcp_tx_limit(evsocket::get_buffer_size(sock, true) * tcp_tx_limit_mult)
 {
     log_debug_printf(connio, "Client %s connects, RX readahead %zu TX limit %zu\n",
@@ -81,6 +159,17 @@ ServerConn::ServerConn(ServIface* iface, evutil_socket_t sock, struct sockaddr *
 
     bufferevent_setcb(bev.get(), &bevReadS, &bevWriteS, &bevEventS, this);
 
+    txSegment = iface->server->effective.tcpSegmentSize;
+    rxReserveMax = iface->server->effective.tcpReserveMax;
+
+    if(auto delay = iface->server->effective.tcpFlushDelay) {
+        txFlushDelay.tv_sec = delay/1000000u;
+        txFlushDelay.tv_usec = delay%1000000u;
+        txFlushBytes = iface->server->effective.tcpFlushBytes;
+        txFlushTimer = evevent(__FILE__, __LINE__,
+                               event_new(loop.base, -1, EV_TIMEOUT, &flushTxS, this));
+    }
+
     timeval tmo(totv(iface->server->effective.tcpTimeout));
     bufferevent_set_timeouts(bev.get(), &tmo, &tmo);
 
@@ -347,7 +436,12 @@ void ServerConn::cleanup()
 {
     log_debug_printf(connsetup, "Client %s Cleanup TCP Connection\n", peerName.c_str());
 
-    iface->server->connections.erase(this);
+    {
+        auto serv = iface->server;
+        Guard G(serv->connectionsLock);
+        if(serv->connections.erase(this))
+            serv->tcp_load[worker]--;
+    }
 
     // grab maps before cleanup()s would modify
     auto ops(std::move(opByIOID));
@@ -455,12 +549,30 @@ ServIface::ServIface(const SockAddr &addr, server::Server::Pvt *server, bool fal
 void ServIface::onConnS(struct evconnlistener *listener, evutil_socket_t sock, struct sockaddr *peer, int socklen, void *raw)
 {
     auto self = static_cast<ServIface*>(raw);
+    auto serv = self->server;
+    auto worker = serv->pickWorker();
     try {
-        auto conn(std::make_shared<ServerConn>(self, sock, peer, socklen));
-        self->server->connections[conn.get()] = std::move(conn);
+        SockAddr peerAddr(peer, socklen);
+        auto loop(serv->tcp_workers[worker].internal());
+
+        // connection is created, and thereafter serviced, by the chosen worker.
+        loop.dispatch([self, serv, loop, worker, sock, peerAddr]() {
+            try {
+                auto conn(std::make_shared<ServerConn>(self, loop, worker, sock, peerAddr));
+                Guard G(serv->connectionsLock);
+                serv->connections[conn.get()] = std::move(conn);
+            }catch(std::exception& e){
+                log_exc_printf(connsetup, "Interface %s Unhandled error in accept: %s\n", self->name.c_str(), e.what());
+                evutil_closesocket(sock);
+                Guard G(serv->connectionsLock);
+                serv->tcp_load[worker]--;
+            }
+        });
     }catch(std::exception& e){
         log_exc_printf(connsetup, "Interface %s Unhandled error in accept callback: %s\n", self->name.c_str(), e.what());
         evutil_closesocket(sock);
+        Guard G(serv->connectionsLock);
+        serv->tcp_load[worker]--;
     }
 }
 
@@ -501,7 +613,7 @@ void ServerOp::cleanup()
             conn->opByIOID.erase(ioid);
 
             if(notify) {
-                conn->iface->server->acceptor_loop.dispatch([closer](){
+                conn->loop.dispatch([closer](){
                     closer("");
                 });
                 notify = false;
@@ -13,6 +13,7 @@
 #include <atomic>
 
 #include <epicsEvent.h>
+#include <epicsMutex.h>
 
 #include <pvxs/server.h>
 #include <pvxs/source.h>
@@ -57,6 +58,33 @@ struct ServerOp
     virtual void show(std::ostream& strm) const =0;
 };
 
+/* Serialized form of a posted Value, shared between all MONITOR operations
+ * which have the same pvRequest mask.  So that an update
+ * post()'d to many subscribers is encoded once.
+ * cf. server::MonitorFanout
+ */
+struct MonitorWire
+{
+    // keep posted Value alive while cached
+    const Value val;
+    BitMask mask; // const after ctor
+    const bool BE;
+
+    MonitorWire(const Value& val, const BitMask& mask, bool BE);
+
+    // append to_wire_valid() of val.  Encodes on first call.
+    // returns true when an existing encoding was re-used.
+    bool append(evbuffer* out);
+
+    // has append() been called
+    bool cached();
+
+private:
+    epicsMutex lock;
+    evbuf buf;
+    bool encoded = false;
+};
+
 struct ServerChannelControl : public server::ChannelControl
 {
     ServerChannelControl(const std::shared_ptr<ServerConn>& conn, const std::shared_ptr<ServerChan>& chan);
@@ -72,6 +100,7 @@ struct ServerChannelControl : public server::ChannelControl
     virtual void _updateInfo(const std::shared_ptr<const ReportInfo>& info) override final;
 
     const std::weak_ptr<server::Server::Pvt> server;
+    const evbase loop;
     const std::weak_ptr<ServerChan> chan;
 
     INST_COUNTER(ServerChannelControl);
@@ -110,9 +139,60 @@ struct ServerChan
     void cleanup();
 };
 
+/* Replies queued from other threads, eg. by post(), for one connection.
+ * The worker is woken once per batch, instead of once per reply.
+ */
+struct ReplyQueue final : public std::enable_shared_from_this<ReplyQueue>
+{
+    const evbase loop;
+
+    explicit ReplyQueue(const evbase& loop) :loop(loop) {}
+    ReplyQueue(const ReplyQueue&) = delete;
+    ReplyQueue& operator=(const ReplyQueue&) = delete;
+
+    // from any thread
+    void push(mfunction&& fn);
+
+    // worker only.  Number of times run(), and number of replies so run.
+    size_t statBatch = 0u, statReply = 0u;
+private:
+    friend struct ReplyBatch;
+    void wakeup();
+    // on worker
+    void run();
+
+    epicsMutex lock;
+    // guarded by lock
+    std::vector<mfunction> pending;
+    bool scheduled = false;
+    // worker only
+    std::vector<mfunction> running;
+};
+
+/* While in scope, ReplyQueue::push() from the current thread defers waking
+ * workers until the outermost ReplyBatch is destroyed.
+ * So replies queued for one connection are sent together.
+ */
+struct ReplyBatch {
+    ReplyBatch();
+    ~ReplyBatch();
+    ReplyBatch(const ReplyBatch&) = delete;
+    ReplyBatch& operator=(const ReplyBatch&) = delete;
+private:
+    friend struct ReplyQueue;
+    // ReplyQueues to be woken.  Only in outermost
+    std::vector<std::shared_ptr<ReplyQueue>> wake;
+    ReplyBatch* const outer;
+};
+
 struct ServerConn final : public ConnBase, public std::enable_shared_from_this<ServerConn>
 {
     ServIface* const iface;
+    // worker servicing this connection, and all of its channels and operations.
+    const evbase loop;
+    const std::shared_ptr<ReplyQueue> replies;
+    // index in Server::Pvt::tcp_workers
+    const size_t worker;
     const size_t tcp_tx_limit;
 
     std::shared_ptr<const server::ClientCredentials> cred;
@@ -125,7 +205,7 @@ struct ServerConn final : public ConnBase, public std::enable_shared_from_this<S
 
     INST_COUNTER(ServerConn);
 
-    ServerConn(ServIface* iface, evutil_socket_t sock, struct sockaddr *peer, int socklen);
+    ServerConn(ServIface* iface, const evbase& loop, size_t worker, evutil_socket_t sock, const SockAddr& peer);
     ServerConn(const ServerConn&) = delete;
     ServerConn& operator=(const ServerConn&) = delete;
     ~ServerConn();
@@ -193,6 +273,8 @@ struct ServerSource : public server::Source
 
     ServerSource(server::Server::Pvt* serv);
 
+    virtual std::shared_ptr<const server::SearchFilter> searchFilter() override final;
+
     virtual void onSearch(Search &op) override final;
 
     virtual void onCreate(std::unique_ptr<server::ChannelControl> &&op) override final;
@@ -222,27 +304,52 @@ struct Server::Pvt
     // handle server "background" tasks.
     // accept new connections and send beacons
     evbase acceptor_loop;
+    // handle TCP connections.
+    // Only acceptor_loop when effective.tcpWorkers==1
+    std::vector<evbase> tcp_workers;
 
     std::list<std::unique_ptr<UDPListener> > listeners;
     std::vector<SockEndpoint> beaconDest;
+    // scratch for batched beacon TX
+    std::vector<sendmmsgx::Dest> beaconBatch;
     std::vector<SockAddr> ignoreList;
 
     std::list<ServIface> interfaces;
+
+    // guards connections and tcp_load
+    epicsMutex connectionsLock;
     std::map<ServerConn*, std::shared_ptr<ServerConn> > connections;
+    // number of connections assigned to each of tcp_workers
+    std::vector<size_t> tcp_load;
 
     evsocket beaconSender4, beaconSender6;
     evevent beaconTimer;
 
     std::vector<uint8_t> searchReply;
 
+    // re-usable storage for searchSources()
+    struct SearchScratch {
+        // names offered to one Source with a SearchFilter, and their index in the full Search
+        Source::Search sub;
+        std::vector<size_t> idx;
+        // whether each name has been offered to any Source
+        std::vector<uint8_t> offered;
+    };
+
     // properly a local of Pvt::onSearch() on the UDP worker.
     // made a member to avoid re-alloc of _names vector.
     Source::Search searchOp;
+    SearchScratch searchScratch;
 
     StaticSource builtinsrc;
 
     RWLock sourcesLock;
     std::map<std::pair<int, std::string>, std::shared_ptr<Source> > sources;
+    // Source::searchFilter() of each entry in sources, with the same keys.  May be NULL.
+    std::map<std::pair<int, std::string>, std::shared_ptr<const SearchFilter> > searchFilters;
+
+    // search statistics.  Names offered to at least one Source (hit) or to none (miss).
+    std::atomic<size_t> statSearchHit{0u}, statSearchMiss{0u};
 
     enum state_t {
         Stopped,
@@ -259,6 +366,14 @@ struct Server::Pvt
     void start();
     void stop();
 
+    // select, and reserve, a slot on the least loaded of tcp_workers
+    size_t pickWorker();
+    // snapshot of current connections
+    std::vector<std::shared_ptr<ServerConn>> listConnections();
+
+    // offer names to each Source, applying any SearchFilter.  Caller must lock sourcesLock for reading.
+    void searchSources(Source::Search& op, SearchScratch& scratch);
+
 private:
     void onSearch(const UDPManager::Search& msg);
     void doBeacons(short evt);
@@ -172,6 +172,7 @@ struct ServerGPRConnect : public server::ConnectOp
                      const std::weak_ptr<ServerGPR>& op)
         :server::ConnectOp(name, conn->cred, cmd2op(cmd), request)
         ,server(server)
+        ,loop(conn->loop)
         ,op(op)
     {}
     virtual ~ServerGPRConnect() {
@@ -183,7 +184,7 @@ struct ServerGPRConnect : public server::ConnectOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &prototype](){
+        loop.call([this, &prototype](){
             if(auto oper = op.lock()) {
                 if(oper->state!=ServerOp::Creating)
                     return;
@@ -211,7 +212,7 @@ struct ServerGPRConnect : public server::ConnectOp
         if(!serv)
             return;
         auto op(this->op);
-        serv->acceptor_loop.dispatch([op, msg](){
+        loop.dispatch([op, msg](){
             if(auto oper = op.lock()) {
                 if(oper->state==ServerOp::Creating)
                     oper->doReply(Value(), msg);
@@ -224,7 +225,7 @@ struct ServerGPRConnect : public server::ConnectOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onGet = std::move(fn);
         });
@@ -234,7 +235,7 @@ struct ServerGPRConnect : public server::ConnectOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onPut = std::move(fn);
         });
@@ -244,13 +245,14 @@ struct ServerGPRConnect : public server::ConnectOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onClose = std::move(fn);
         });
     }
 
     const std::weak_ptr<server::Server::Pvt> server;
+    const evbase loop;
     const std::weak_ptr<ServerGPR> op;
 
     INST_COUNTER(ServerGPRConnect);
@@ -267,6 +269,7 @@ struct ServerGPRExec : public server::ExecOp
                   const std::shared_ptr<ServerGPR>& op)
         :server::ExecOp(name, conn->cred, cmd2op(cmd), op->pvRequest)
         ,server(server)
+        ,loop(conn->loop)
         ,op(op)
     {}
     virtual ~ServerGPRExec() {}
@@ -282,7 +285,7 @@ struct ServerGPRExec : public server::ExecOp
         if(!serv)
             return;
         auto op(this->op);
-        serv->acceptor_loop.dispatch([op, val](){
+        loop.dispatch([op, val](){
             if(auto oper = op.lock()) {
                 oper->doReply(val, std::string());
             }
@@ -297,7 +300,7 @@ struct ServerGPRExec : public server::ExecOp
         if(!serv)
             return;
         auto op(this->op);
-        serv->acceptor_loop.dispatch([op, msg](){
+        loop.dispatch([op, msg](){
             if(auto oper = op.lock()) {
                 oper->doReply(Value(), msg);
             }
@@ -309,7 +312,7 @@ struct ServerGPRExec : public server::ExecOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onCancel = std::move(fn);
         });
@@ -321,10 +324,11 @@ struct ServerGPRExec : public server::ExecOp
         if(!serv)
             throw std::logic_error("Can't start timer on deal server");
 
-        return Timer::Pvt::buildOneShot(delay, serv->acceptor_loop.internal(), std::move(fn));
+        return Timer::Pvt::buildOneShot(delay, loop, std::move(fn));
     }
 
     const std::weak_ptr<server::Server::Pvt> server;
+    const evbase loop;
     const std::weak_ptr<ServerGPR> op;
 
     INST_COUNTER(ServerGPRExec);
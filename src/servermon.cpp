@@ -6,7 +6,6 @@
 
 #include <cassert>
 
-#include <deque>
 
 #include <epicsMutex.h>
 #include <epicsGuard.h>
@@ -16,14 +15,53 @@
 #include "serverconn.h"
 #include "pvrequest.h"
 
-namespace pvxs { namespace impl {
+namespace pvxs {
+namespace server {
+struct MonitorFanout::Pvt {
+    const Value val;
+    // serializations of val, one per distinct (mask, BE)
+    std::vector<std::shared_ptr<impl::MonitorWire>> wires;
+    Pvt* const prev;
+
+    Pvt(const Value& val, Pvt* prev) :val(val), prev(prev) {}
+
+    std::shared_ptr<impl::MonitorWire> wire(const Value& posted, const BitMask& mask, bool BE)
+    {
+        if(Value::Helper::store_ptr(posted)!=Value::Helper::store_ptr(val))
+            return nullptr; // not the Value being fanned out
+
+        for(auto& wire : wires) {
+            if(wire->BE==BE && wire->mask==mask)
+                return wire;
+        }
+        wires.push_back(std::make_shared<impl::MonitorWire>(val, mask, BE));
+        return wires.back();
+    }
+};
+} // namespace server
+
+namespace impl {
 DEFINE_LOGGER(connsetup, "pvxs.tcp.setup");
 DEFINE_LOGGER(connio, "pvxs.tcp.io");
 
+// innermost MonitorFanout of this thread
+static thread_local server::MonitorFanout::Pvt* currentFanout;
+
 namespace {
 
 typedef epicsGuard<epicsMutex> Guard;
 
+// queued update
+struct MonitorUpdate {
+    // empty for finish()
+    Value val;
+    // shared serialization.  May be NULL
+    std::shared_ptr<MonitorWire> wire;
+
+    MonitorUpdate() = default;
+    MonitorUpdate(const Value& val, const std::shared_ptr<MonitorWire>& wire) :val(val), wire(wire) {}
+};
+
 struct MonitorOp final : public ServerOp
 {
     MonitorOp(const std::shared_ptr<ServerChan>& chan, uint32_t ioid)
@@ -41,7 +79,7 @@ struct MonitorOp final : public ServerOp
     }
     virtual ~MonitorOp() {}
 
-    // only access from accepter worker thread
+    // only access from connection worker thread
     std::function<void(bool)> onStart;
     std::function<void()> onLowMark;
     std::function<void()> onHighMark;
@@ -52,6 +90,7 @@ struct MonitorOp final : public ServerOp
     std::shared_ptr<const FieldDesc> type;
     BitMask pvMask;
     std::string msg;
+    std::shared_ptr<ReplyQueue> replies;
 
     // Further members guarded by this lock (except as noted)
     mutable epicsMutex lock;
@@ -66,21 +105,23 @@ struct MonitorOp final : public ServerOp
     size_t ackAt=1u;
     size_t maxQueue=0u;
     size_t nSquash=0u;
+    size_t nEncode=0u;
+    size_t nShared=0u;
 
-    std::deque<Value> queue;
+    RingQueue<MonitorUpdate> queue;
 
     INST_COUNTER(MonitorOp);
 
     // caller must hold lock.
     // only used after State==Idle
     static
-    void maybeReply(server::Server::Pvt* server, const std::shared_ptr<MonitorOp>& op)
+    void maybeReply(const evbase& loop, const std::shared_ptr<MonitorOp>& op)
     {
         // can we send a reply?
         if(!op->scheduled && op->state==Executing && !op->queue.empty() && (!op->pipeline || op->window))
         {
             // based on operation state, yes
-            server->acceptor_loop.dispatch([op](){
+            mfunction reply([op](){
                 auto ch(op->chan.lock());
                 if(!ch)
                     return;
@@ -96,6 +137,12 @@ struct MonitorOp final : public ServerOp
                 }
             });
 
+            // batch with replies for other subscriptions on this connection
+            if(op->replies)
+                op->replies->push(std::move(reply));
+            else
+                loop.dispatch(std::move(reply));
+
             op->scheduled = true;
         } else {
             log_debug_printf(connio, "Skip reply sch=%c st=%u q=%zu p=%c w=%zu\n",
@@ -136,7 +183,7 @@ struct MonitorOp final : public ServerOp
                                  conn->peerName.c_str(), unsigned(self->ioid));
                 return; // nothing to do
 
-            } else if(!self->queue.front()) {
+            } else if(!self->queue.front().val) {
                 subcmd = 0x10;
                 self->state = Dead;
                 log_debug_printf(connio, "Client %s IOID %u finishes\n",
@@ -144,6 +191,8 @@ struct MonitorOp final : public ServerOp
             }
         }
 
+        // set when the update is serialized by MonitorWire
+        std::shared_ptr<MonitorWire> wire;
         {
             (void)evbuffer_drain(conn->txBody.get(), evbuffer_get_length(conn->txBody.get()));
 
@@ -161,10 +210,16 @@ struct MonitorOp final : public ServerOp
 
             } else if(!self->queue.empty()) {
                 auto& ent = self->queue.front();
-                if(ent) {
-                    to_wire_valid(R, ent, &self->pvMask);
+                if(ent.val && ent.wire && (ent.wire.use_count()>1u || ent.wire->cached())) {
+                    // update also queued for, or already sent to, another subscription.
+                    // must flush R before appending.
+                    wire = std::move(ent.wire);
+
+                } else if(ent.val) {
+                    to_wire_valid(R, ent.val, &self->pvMask);
                     // TODO: placeholder for overrun mask
                     to_wire(R, uint8_t(0u));
+                    self->nEncode++;
 
                 } else { // finish (could be used to send an error)
                     to_wire(R, Status{});
@@ -174,6 +229,17 @@ struct MonitorOp final : public ServerOp
             }
         }
 
+        if(wire) {
+            if(wire->append(conn->txBody.get()))
+                self->nShared++;
+            else
+                self->nEncode++;
+
+            EvOutBuf R(conn->sendBE, conn->txBody.get());
+            // TODO: placeholder for overrun mask
+            to_wire(R, uint8_t(0u));
+        }
+
         ch->statTx += conn->enqueueTxBody(pva_app_msg_t::CMD_MONITOR);
 
         if(self->state == ServerOp::Dead) {
@@ -187,7 +253,7 @@ struct MonitorOp final : public ServerOp
 
             if(!self->lowMarkPending && self->window <= self->low && self->onLowMark) {
                 self->lowMarkPending = true;
-                conn->iface->server->acceptor_loop.dispatch([self]() {
+                conn->loop.dispatch([self]() {
                     decltype (self->onLowMark) fn;
                     {
                         Guard G(self->lock);
@@ -205,7 +271,7 @@ struct MonitorOp final : public ServerOp
             // reschedule myself
             assert(!self->scheduled); // we've been holding the lock, so this should not have changed
 
-            conn->iface->server->acceptor_loop.dispatch([self]() {
+            conn->loop.dispatch([self]() {
                 doReply(self);
             });
             self->scheduled = true;
@@ -252,6 +318,13 @@ struct ServerMonitorControl : public server::MonitorControlOp
         // pvMask is const at this point, so no need to lock
         bool real = testmask(val, mon->pvMask);
 
+        // post()ing the same Value to several subscriptions shares one serialization
+        std::shared_ptr<MonitorWire> wire;
+        if(real && currentFanout) {
+            if(auto serv = server.lock())
+                wire = currentFanout->wire(val, mon->pvMask, serv->effective.sendBE());
+        }
+
         Guard G(mon->lock);
         if(mon->finished)
             return false;
@@ -261,7 +334,7 @@ struct ServerMonitorControl : public server::MonitorControlOp
             if((mon->queue.size() < mon->limit) || force || !val) {
 
                 mon->finished = !val;
-                mon->queue.push_back(val);
+                mon->queue.emplace_back(val, wire);
 
                 if(mon->maxQueue < mon->queue.size())
                     mon->maxQueue = mon->queue.size();
@@ -270,7 +343,16 @@ struct ServerMonitorControl : public server::MonitorControlOp
                 // squash
                 assert(mon->limit>0 && !mon->queue.empty());
 
-                mon->queue.back().assign(val);
+                auto& back = mon->queue.back();
+                if(back.wire) {
+                    // queued Value is shared with other subscriptions, so merge into a copy
+                    auto merged(back.val.clone());
+                    merged.assign(val);
+                    back.val = std::move(merged);
+                    back.wire.reset();
+                } else {
+                    back.val.assign(val);
+                }
                 mon->nSquash++;
 
             } else {
@@ -278,7 +360,7 @@ struct ServerMonitorControl : public server::MonitorControlOp
             }
 
             if(auto serv = server.lock())
-                MonitorOp::maybeReply(serv.get(), mon);
+                MonitorOp::maybeReply(loop, mon);
         }
 
         return mon->queue.size() < mon->limit;
@@ -300,10 +382,12 @@ struct ServerMonitorControl : public server::MonitorControlOp
         stat.maxQueue = mon->maxQueue;
         stat.limitQueue = mon->limit;
         stat.window = mon->window;
-        stat.nQueue = mon->nSquash;
+        stat.nSquash = mon->nSquash;
+        stat.nEncode = mon->nEncode;
+        stat.nShared = mon->nShared;
 
         if(reset)
-            mon->maxQueue = mon->nSquash = 0u;
+            mon->maxQueue = mon->nSquash = mon->nEncode = mon->nShared = 0u;
     }
 
     virtual void setWatermarks(size_t low, size_t high) override final
@@ -314,7 +398,7 @@ struct ServerMonitorControl : public server::MonitorControlOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, low, high](){
+        loop.call([this, low, high](){
             if(auto oper = op.lock()) {
                 Guard G(oper->lock);
                 oper->low = std::min(low, oper->ackAt-1u);
@@ -329,7 +413,7 @@ struct ServerMonitorControl : public server::MonitorControlOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onStart = std::move(fn);
         });
@@ -339,7 +423,7 @@ struct ServerMonitorControl : public server::MonitorControlOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onHighMark = std::move(fn);
         });
@@ -349,13 +433,14 @@ struct ServerMonitorControl : public server::MonitorControlOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onLowMark = std::move(fn);
         });
     }
 
     const std::weak_ptr<server::Server::Pvt> server;
+    const evbase loop;
     const std::weak_ptr<MonitorOp> op;
 
     INST_COUNTER(ServerMonitorControl);
@@ -371,6 +456,7 @@ struct ServerMonitorSetup : public server::MonitorSetupOp
                      const std::weak_ptr<MonitorOp>& op)
         :MonitorSetupOp(name, conn->cred, Info, request)
         ,server(server)
+        ,loop(conn->loop)
         ,op(op)
     {}
     virtual ~ServerMonitorSetup() {
@@ -389,7 +475,7 @@ struct ServerMonitorSetup : public server::MonitorSetupOp
         auto serv = server.lock();
         if(!serv)
             return ret;
-        serv->acceptor_loop.call([this, &type, &ret, &mask](){
+        loop.call([this, &type, &ret, &mask](){
             if(auto oper = op.lock()) {
                 if(oper->state!=ServerOp::Creating)
                     return;
@@ -412,7 +498,7 @@ struct ServerMonitorSetup : public server::MonitorSetupOp
         if(!serv)
             return;
         auto op(this->op);
-        serv->acceptor_loop.dispatch([op, msg]() mutable {
+        loop.dispatch([op, msg]() mutable {
             if(auto oper = op.lock()) {
                 if(oper->state==ServerOp::Creating) {
                     oper->msg = std::move(msg);
@@ -426,13 +512,14 @@ struct ServerMonitorSetup : public server::MonitorSetupOp
         auto serv = server.lock();
         if(!serv)
             return;
-        serv->acceptor_loop.call([this, &fn](){
+        loop.call([this, &fn](){
             if(auto oper = op.lock())
                 oper->onClose = std::move(fn);
         });
     }
 
     const std::weak_ptr<server::Server::Pvt> server;
+    const evbase loop;
     const std::weak_ptr<MonitorOp> op;
 
     INST_COUNTER(ServerMonitorSetup);
@@ -446,11 +533,55 @@ ServerMonitorControl::ServerMonitorControl(ServerMonitorSetup* setup,
                                            const std::weak_ptr<MonitorOp>& op)
     :server::MonitorControlOp(name, setup->credentials(), Info)
     ,server(server)
+    ,loop(setup->loop)
     ,op(op)
 {}
 
 } // namespace
 
+MonitorWire::MonitorWire(const Value& val, const BitMask& mask, bool BE)
+    :val(val)
+    ,mask(mask.size())
+    ,BE(BE)
+    ,buf(__FILE__, __LINE__, evbuffer_new())
+{
+    for(auto i : range(mask.wsize()))
+        this->mask.word(i) = mask.word(i);
+
+    // chains of buf may be referenced, and released, from several TCP workers
+    if(evbuffer_enable_locking(buf.get(), nullptr))
+        throw std::bad_alloc();
+}
+
+bool MonitorWire::append(evbuffer* out)
+{
+    Guard G(lock);
+
+    bool reuse = encoded;
+    if(!encoded) {
+        EvOutBuf R(BE, buf.get());
+        to_wire_valid(R, val, &mask);
+        encoded = true;
+    }
+
+#if LIBEVENT_VERSION_NUMBER >= 0x02010100
+    // share chains of buf without copying
+    auto err = evbuffer_add_buffer_reference(out, buf.get());
+#else
+    auto err = evbuffer_add(out, evbuffer_pullup(buf.get(), -1), evbuffer_get_length(buf.get()));
+#endif
+    if(err)
+        throw std::bad_alloc();
+
+    return reuse;
+}
+
+bool MonitorWire::cached()
+{
+    Guard G(lock);
+    return encoded;
+}
+
 void ServerConn::handle_MONITOR()
 {
     auto rxlen = 8u + evbuffer_get_length(segBuf.get());
@@ -491,6 +622,7 @@ void ServerConn::handle_MONITOR()
         chan->statRx += rxlen;
 
         auto op(std::make_shared<MonitorOp>(chan, ioid));
+        op->replies = replies;
         op->window = nack;
         (void)pvRequest["record._options.pipeline"].as(op->pipeline);
 
@@ -504,6 +636,11 @@ void ServerConn::handle_MONITOR()
         if(!op->limit)
             op->limit = 1u;
 
+        // room for a full queue, plus the finish() marker.
+        // queueSize is client controlled, so bound the up front allocation.
+        // force=true post() may still grow the queue.
+        op->queue.reserve(std::min<size_t>(op->limit+1u, 1024u));
+
         auto ackAny = pvRequest["record._options.ackAny"];
         if(ackAny.type()==TypeCode::String) {
             auto sval = ackAny.as<std::string>();
@@ -609,7 +746,7 @@ void ServerConn::handle_MONITOR()
 
             if(!op->highMarkPending && op->window > op->high && op->onHighMark && !op->finished) {
                 op->highMarkPending = true;
-                iface->server->acceptor_loop.dispatch([op](){
+                loop.dispatch([op](){
                     decltype(op->onHighMark) fn;
                     {
                         Guard G(op->lock);
@@ -639,7 +776,7 @@ void ServerConn::handle_MONITOR()
 
             {
                 Guard G(op->lock);
-                MonitorOp::maybeReply(iface->server, op);
+                MonitorOp::maybeReply(loop, op);
             }
         }
 
@@ -652,7 +789,7 @@ void ServerConn::handle_MONITOR()
                 auto self(it->second);
                 opByIOID.erase(it);
 
-                iface->server->acceptor_loop.dispatch([self](){
+                loop.dispatch([self](){
                     self->cleanup();
                 });
 
@@ -664,4 +801,20 @@ void ServerConn::handle_MONITOR()
     }
 }
 
-}} // namespace pvxs::impl
+} // namespace impl
+
+namespace server {
+
+MonitorFanout::MonitorFanout(const Value& val)
+    :pvt(new Pvt(val, impl::currentFanout))
+{
+    impl::currentFanout = pvt.get();
+}
+
+MonitorFanout::~MonitorFanout()
+{
+    impl::currentFanout = pvt->prev;
+}
+
+} // namespace server
+} // namespace pvxs
@@ -22,6 +22,12 @@ ServerSource::ServerSource(server::Server::Pvt* serv)
                   }).create())
 {}
 
+std::shared_ptr<const server::SearchFilter> ServerSource::searchFilter()
+{
+    // never claims any name
+    return std::make_shared<server::SearchFilter>(0u);
+}
+
 void ServerSource::onSearch(Search &op)
 {
     // nothing.  our "server" PV is not advertised
@@ -18,6 +18,7 @@
 
 #include "utilpvt.h"
 #include "dataimpl.h"
+#include "serverconn.h"
 
 typedef epicsGuard<epicsMutex> Guard;
 typedef epicsGuardRelease<epicsMutex> UnGuard;
@@ -100,6 +101,30 @@ struct SharedPV::Impl : public std::enable_shared_from_this<Impl>
             conn->error(e.what());
         }
     }
+
+    // Caller must lock, and check type.
+    // An owned Value is not otherwise referenced, and is queued to subscribers without a copy.
+    void doPost(const Value& val, bool owned)
+    {
+        current.assign(val);
+
+        if(subscribers.empty())
+            return;
+
+        auto copy(owned ? val : val.clone());
+
+        if(subscribers.size()==1u) {
+            (*subscribers.begin())->post(copy);
+            return;
+        }
+
+        // encode once for all subscribers
+        server::MonitorFanout F(copy);
+
+        for(auto& sub : subscribers) {
+            sub->post(copy);
+        }
+    }
 };
 DEFINE_INST_COUNTER2(SharedPV::Impl, SharedPVImpl);
 
@@ -421,6 +446,8 @@ void SharedPV::post(const Value& val)
     else if(!val)
         throw std::logic_error("Can't post() empty Value");
 
+    // send the replies for each connection together, after unlocking
+    impl::ReplyBatch B;
     Guard G(impl->lock);
 
     if(!impl->current)
@@ -428,16 +455,92 @@ void SharedPV::post(const Value& val)
     else if(Value::Helper::desc(impl->current)!=Value::Helper::desc(val))
         throw std::logic_error("post() requires the exact type of open().  Recommend pvxs::Value::cloneEmpty()");
 
-    impl->current.assign(val);
+    impl->doPost(val, false);
+}
+
+struct PostBatch::Pvt {
+    std::vector<std::pair<SharedPV, Value>> posts;
+    // SharedPV::Impl -> index in posts
+    std::map<const SharedPV::Impl*, size_t> index;
+    // posts[i].second was cloned, and may be modified
+    std::vector<bool> owned;
+};
+
+PostBatch::PostBatch() :pvt(new Pvt) {}
+PostBatch::~PostBatch() {}
 
-    if(impl->subscribers.empty())
-        return;
+PostBatch& PostBatch::post(const SharedPV& pv, const Value& val)
+{
+    if(!pv)
+        throw std::logic_error("Empty SharedPV");
+    else if(!val)
+        throw std::logic_error("Can't post() empty Value");
 
-    auto copy(val.clone());
+    auto it(pvt->index.find(pv.impl.get()));
+    if(it==pvt->index.end()) {
+        pvt->index.emplace(pv.impl.get(), pvt->posts.size());
+        pvt->posts.emplace_back(pv, val);
+        pvt->owned.push_back(false);
 
-    for(auto& sub : impl->subscribers) {
-        sub->post(copy);
+    } else {
+        // merge with earlier update to the same PV.  Don't modify the caller's Value.
+        auto& prev = pvt->posts[it->second].second;
+        if(Value::Helper::desc(prev)!=Value::Helper::desc(val))
+            throw std::logic_error("post() requires the exact type of open().  Recommend pvxs::Value::cloneEmpty()");
+        if(!pvt->owned[it->second]) {
+            prev = prev.clone();
+            pvt->owned[it->second] = true;
+        }
+        prev.assign(val);
     }
+    return *this;
+}
+
+size_t PostBatch::size() const
+{
+    return pvt->posts.size();
+}
+
+void PostBatch::clear()
+{
+    pvt->posts.clear();
+    pvt->index.clear();
+    pvt->owned.clear();
+}
+
+void PostBatch::commit()
+{
+    // defer waking workers until all updates are queued, and all PVs unlocked
+    impl::ReplyBatch B;
+
+    // hold the locks of all PVs, taken in address order, so that a concurrent
+    // close() or open() can not intervene between checking and applying.
+    struct Locks {
+        std::vector<epicsMutex*> held;
+        ~Locks() {
+            for(auto it(held.rbegin()); it!=held.rend(); ++it)
+                (*it)->unlock();
+        }
+    } L;
+    L.held.reserve(pvt->index.size());
+
+    for(auto& pair : pvt->index) {
+        auto& lock = pvt->posts[pair.second].first.impl->lock;
+        lock.lock();
+        L.held.push_back(&lock);
+    }
+
+    for(auto& pair : pvt->posts) {
+        if(!pair.first.impl->current)
+            throw std::logic_error("Must open() before post()ing");
+        else if(Value::Helper::desc(pair.first.impl->current)!=Value::Helper::desc(pair.second))
+            throw std::logic_error("post() requires the exact type of open().  Recommend pvxs::Value::cloneEmpty()");
+    }
+
+    for(auto i : range(pvt->posts.size()))
+        pvt->posts[i].first.impl->doPost(pvt->posts[i].second, pvt->owned[i]);
+
+    clear();
 }
 
 void SharedPV::fetch(Value& val) const
@@ -472,15 +575,21 @@ struct StaticSource::Impl final : public Source
 {
     mutable RWLock lock;
 
-    list_t pvs;
+    // hash index for search, and onCreate(), of many names
+    NameIndex<SharedPV> pvs;
     decltype (List::names) list;
+    const std::shared_ptr<SearchFilter> filter{std::make_shared<SearchFilter>(4096u)};
+
+    virtual std::shared_ptr<const SearchFilter> searchFilter() override
+    {
+        return filter;
+    }
 
     virtual void onSearch(Search &op) override
     {
         auto G(lock.lockReader());
         for(auto& name : op) {
-            auto it(pvs.find(name.name()));
-            if(it!=pvs.end()) {
+            if(pvs.find(name.name(), name.length(), name.hash())) {
                 name.claim();
                 log_debug_printf(logsource, "%p claim '%s'\n", this, name.name());
             }
@@ -492,13 +601,12 @@ struct StaticSource::Impl final : public Source
         SharedPV pv;
         {
             auto G(lock.lockReader());
-            auto it(pvs.find(op->name()));
-            bool found = it!=pvs.end();
+            auto found(pvs.find(op->name()));
             log_debug_printf(logsource, "%p %screate '%s'\n",
                              this, found ? "":"can't ", op->name().c_str());
             if(!found)
                 return; // not mine
-            pv = it->second;
+            pv = *found;
         }
 
         pv.attach(std::move(op));
@@ -511,9 +619,9 @@ struct StaticSource::Impl final : public Source
 
         if(!list || list.use_count()!=1u) {
             auto temp = std::make_shared<std::set<std::string>>();
-            for(auto& pair : pvs) {
-                temp->emplace(pair.first);
-            }
+            pvs.visit([&temp](const std::string& name, const SharedPV&) {
+                temp->emplace(name);
+            });
             list = std::move(temp);
         }
 
@@ -527,8 +635,14 @@ struct StaticSource::Impl final : public Source
     {
         strm<<"StaticProvider";
 
-        auto G(lock.lockReader());
-        for(auto& pair : pvs) {
+        list_t sorted;
+        {
+            auto G(lock.lockReader());
+            pvs.visit([&sorted](const std::string& name, const SharedPV& pv) {
+                sorted.emplace(name, pv);
+            });
+        }
+        for(auto& pair : sorted) {
             strm<<"\n"<<indent{}<<pair.first;
             // TODO: details for SharedPV
         }
@@ -559,9 +673,9 @@ void StaticSource::close()
     {
         auto G(impl->lock.lockReader());
 
-        for(auto& pair : impl->pvs) {
-            pair.second.close();
-        }
+        impl->pvs.visit([](const std::string&, SharedPV& pv) {
+            pv.close();
+        });
     }
 }
 
@@ -572,10 +686,18 @@ StaticSource& StaticSource::add(const std::string& name, const SharedPV &pv)
 
     auto G(impl->lock.lockWriter());
 
-    if(impl->pvs.find(name)!=impl->pvs.end())
+    if(!impl->pvs.insert(name, pv).second)
         throw std::logic_error("add() will not create duplicate PV");
 
-    impl->pvs[name] = pv;
+    impl->filter->add(name);
+    if(impl->filter->size() > impl->filter->capacity()) {
+        // filter would pass most names.  Re-size with room to grow.
+        impl->filter->rebuild(2u*impl->filter->size(), [this](const SearchFilter::add_fn& add) {
+            impl->pvs.visit([&add](const std::string& name, const SharedPV&) {
+                add(name.c_str());
+            });
+        });
+    }
     impl->list.reset();
 
     return *this;
@@ -590,12 +712,13 @@ StaticSource& StaticSource::remove(const std::string& name)
     {
         auto G(impl->lock.lockWriter());
 
-        auto it(impl->pvs.find(name));
-        if(it==impl->pvs.end())
+        auto found(impl->pvs.find(name));
+        if(!found)
             return *this;
-        pv = it->second;
-        impl->pvs.erase(it);
+        pv = *found;
+        impl->pvs.erase(name);
         impl->list.reset();
+        impl->filter->remove(name);
     }
 
     pv.close();
@@ -613,8 +736,12 @@ StaticSource::list_t StaticSource::list() const
     {
         auto G(impl->lock.lockReader());
 
-        return impl->pvs; // copies map
+        impl->pvs.visit([&ret](const std::string& name, const SharedPV& pv) {
+            ret.emplace(name, pv);
+        });
     }
+
+    return ret;
 }
 
 } // namespace server
@@ -5,6 +5,7 @@
  */
 
 #include <cstring>
+#include <algorithm>
 #include <epicsAssert.h>
 
 #include "dataimpl.h"
@@ -267,17 +268,18 @@ void Member::Helper::build_tree(std::vector<FieldDesc>& desc, const Member& node
         if(code.code==TypeCode::Struct)
             child.parent_index = cindex-cref;
 
-        fld.mlookup[cnode.name] = cindex-cref;
+        fld.mlookup.insert(cnode.name, cindex-cref);
         fld.miter.emplace_back(cnode.name, cindex-cref);
 
         std::string cname = cnode.name+".";
         if(fld.code.code==TypeCode::Struct && fld.code==child.code) {
             // propagate names from sub-struct
             for(auto& cpair : child.mlookup) {
-                fld.mlookup[cname+cpair.first] = cindex-cref+cpair.second;
+                fld.mlookup.insert(cname+cpair.first, cindex-cref+cpair.second);
             }
         }
     }
+    desc[index].mlookup.finalize();
 
     assert(desc.size()==index+desc[index].size());
 }
@@ -451,6 +453,68 @@ std::ostream& operator<<(std::ostream& strm, const TypeDef& def)
 
 namespace impl {
 
+const std::vector<MemberIndex::value_type> MemberIndex::none;
+
+void MemberIndex::insert(const std::string& name, size_t index)
+{
+    if(!pvt)
+        pvt.reset(new Pvt());
+    pvt->entries.emplace_back(name, index);
+}
+
+void MemberIndex::finalize()
+{
+    if(!pvt)
+        return;
+    auto& entries = pvt->entries;
+    auto& slots = pvt->slots;
+
+    std::stable_sort(entries.begin(), entries.end(), [](const value_type& a, const value_type& b) {
+        return a.first < b.first;
+    });
+
+    // of duplicate names, keep the last inserted
+    size_t out = 0u;
+    for(size_t i=0u; i<entries.size(); i++) {
+        if(i+1u<entries.size() && entries[i].first==entries[i+1u].first)
+            continue;
+        if(out!=i)
+            entries[out] = std::move(entries[i]);
+        out++;
+    }
+    entries.resize(out);
+    entries.shrink_to_fit();
+
+    // at most half full
+    size_t nslot = 4u;
+    while(nslot < 2u*entries.size())
+        nslot *= 2u;
+    slots.assign(nslot, 0u);
+    const size_t mask = nslot-1u;
+
+    for(auto i : range(entries.size())) {
+        auto h = size_t(nameHash(entries[i].first));
+        while(slots[h&mask])
+            h++;
+        slots[h&mask] = uint32_t(i+1u);
+    }
+}
+
+MemberIndex::const_iterator MemberIndex::find(const char* name, size_t len) const
+{
+    if(!pvt || pvt->slots.empty())
+        return end();
+
+    auto& slots = pvt->slots;
+    const size_t mask = slots.size()-1u;
+    for(auto h = size_t(nameHash(name, len)); slots[h&mask]; h++) {
+        auto it = pvt->entries.cbegin() + (slots[h&mask]-1u);
+        if(it->first.size()==len && memcmp(it->first.data(), name, len)==0)
+            return it;
+    }
+    return end();
+}
+
 void show_FieldDesc(std::ostream& strm, const FieldDesc* desc)
 {
     for(auto idx : range(desc->size())) {
@@ -461,7 +525,6 @@ void show_FieldDesc(std::ostream& strm, const FieldDesc* desc)
 
         switch(fld.code.code) {
         case TypeCode::Struct:
-            // note: need to ensure stable lexical iteration order if fld.mlookup ever becomes unordered_map
             for(auto& pair : fld.mlookup) {
                 strm<<indent{}<<"    "<<pair.first<<" -> "<<pair.second<<" ["<<(idx+pair.second)<<"]\n";
             }
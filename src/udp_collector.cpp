@@ -6,6 +6,7 @@
 
 #include <cstring>
 
+#include <algorithm>
 #include <set>
 #include <map>
 #include <vector>
@@ -46,7 +47,9 @@ struct UDPCollector final : public UDPManager::Search,
     evevent rx;
     uint32_t prevndrop{};
 
+    // RX buffer slots, one per datagram in a batch
     std::vector<uint8_t> buf;
+    std::vector<recvmmsgx::Msg> msgs;
 
     UDPManager::Beacon beaconMsg;
 
@@ -58,7 +61,8 @@ struct UDPCollector final : public UDPManager::Search,
     void addListener(UDPListener *l);
     void delListener(UDPListener *l);
 
-    bool handle_one();
+    bool handle_batch();
+    bool is_slot(const uint8_t* pbuf) const;
 
     enum origin_t {
         Remote,    // non-local sender
@@ -76,8 +80,8 @@ struct UDPCollector final : public UDPManager::Search,
             if(!(ev&EV_READ))
                 return;
 
-            // handle up to 4 packets before going back to the reactor
-            for(unsigned i=0; i<4 && self->handle_one(); i++) {}
+            // handle up to 4 batches of packets before going back to the reactor
+            for(unsigned i=0; i<4 && self->handle_batch(); i++) {}
 
         }catch(std::exception& e) {
             log_crit_printf(logio, "Ignoring unhandled exception in UDPManager::handle(): %s\n", e.what());
@@ -102,9 +106,13 @@ struct UDPManager::Pvt {
     // key'd by address family and port#
     std::map<std::pair<int, uint16_t>, UDPCollector*> collectors;
 
+    // max. number of datagrams received with one syscall
+    const size_t rxBatch;
+
     Pvt()
         :loop("PVXUDP", epicsThreadPriorityCAServerLow-4)
         ,ifmap(IfaceMap::instance())
+        ,rxBatch(udpRxBatch())
     {}
     ~Pvt()
     {
@@ -224,24 +232,32 @@ void UDPCollector::delListener(UDPListener *l)
 // size of a CMD_ORIGIN_TAG prefix header
 static constexpr size_t cmd_origin_tag_size = 8 + 16;
 
-bool UDPCollector::handle_one()
+// size of one RX buffer slot.
+// For Search messages, we use PV name strings in-place by adding nils.
+// Ensure one extra byte at the end of the buffer for a nil after the last PV name
+static constexpr size_t rx_slot_size = cmd_origin_tag_size + 0x10000 + 1;
+
+bool UDPCollector::is_slot(const uint8_t *pbuf) const
 {
-    SockAddr dest;
+    auto off = size_t(pbuf - buf.data());
+    return pbuf>=buf.data() && off<buf.size() && off%rx_slot_size==cmd_origin_tag_size;
+}
 
-    buf.resize(cmd_origin_tag_size + 0x10000 + 1);
-    auto rxbuf = &buf[cmd_origin_tag_size];
-    auto rxlen = buf.size()-cmd_origin_tag_size-1;
+bool UDPCollector::handle_batch()
+{
+    const auto nmsg = manager->rxBatch;
+    if(msgs.size()!=nmsg) {
+        buf.resize(nmsg * rx_slot_size);
+        msgs.resize(nmsg);
+        for(size_t i=0u; i<nmsg; i++) {
+            msgs[i].buf = &buf[i*rx_slot_size + cmd_origin_tag_size];
+            msgs[i].buflen = rx_slot_size - cmd_origin_tag_size - 1u;
+        }
+    }
 
-    // For Search messages, we use PV name strings in-place by adding nils.
-    // Ensure one extra byte at the end of the buffer for a nil after the last PV name
-    recvfromx rx{sock.sock, (char*)rxbuf, rxlen, &src, &dest};
+    recvmmsgx rx{sock.sock, msgs.data(), nmsg};
     const int nrx = rx.call();
 
-    if(nrx>=0 && rx.ndrop!=0u && prevndrop!=rx.ndrop) {
-        log_debug_printf(logio, "UDP collector socket buffer overflowed %u -> %u\n", unsigned(prevndrop), unsigned(rx.ndrop));
-        prevndrop = rx.ndrop;
-    }
-
     if(nrx<0) {
         int err = evutil_socket_geterror(sock.sock);
         if(err!=SOCK_EWOULDBLOCK && err!=EAGAIN && err!=SOCK_EINTR) {
@@ -252,22 +268,37 @@ bool UDPCollector::handle_one()
 
     }
 
-    if(dest.family()!=AF_UNSPEC)
-        dest.setPort(bind_addr.port());
+    for(size_t i=0u; i<size_t(nrx); i++) {
+        auto& M = msgs[i];
+        auto rxbuf = static_cast<const uint8_t*>(M.buf);
 
-    if(src.isMCast()) {
-        // should never happen.  It it does, we won't be tricked into amplifying a DDoS.
-        log_debug_printf(logio, "Ignoring UDP with mcast source %s.\n", src.tostring().c_str());
-        return true;
-    }
+        if(M.ndrop!=0u && prevndrop!=M.ndrop) {
+            log_debug_printf(logio, "UDP collector socket buffer overflowed %u -> %u\n", unsigned(prevndrop), unsigned(M.ndrop));
+            prevndrop = M.ndrop;
+        }
+
+        if(M.dst.family()!=AF_UNSPEC)
+            M.dst.setPort(bind_addr.port());
+
+        // used by process_one(), and modified by our reply()
+        src = M.src;
 
-    log_hex_printf(logio, Level::Debug, rxbuf, nrx, "UDP Rx %d, %s -> %s @%u (%s)\n",
-            nrx, src.tostring().c_str(), dest.tostring().c_str(), unsigned(rx.dstif), bind_addr.tostring().c_str());
+        if(src.isMCast()) {
+            // should never happen.  It it does, we won't be tricked into amplifying a DDoS.
+            log_debug_printf(logio, "Ignoring UDP with mcast source %s.\n", src.tostring().c_str());
+            continue;
+        }
+
+        log_hex_printf(logio, Level::Debug, rxbuf, M.nrx, "UDP Rx %u, %s -> %s @%u (%s)\n",
+                unsigned(M.nrx), src.tostring().c_str(), M.dst.tostring().c_str(), unsigned(M.dstif), bind_addr.tostring().c_str());
 
-    origin_t origin = manager->ifmap.is_iface(src) ? Local : Remote;
+        origin_t origin = manager->ifmap.is_iface(src) ? Local : Remote;
+
+        process_one(M.dst, rxbuf, M.nrx, origin);
+    }
 
-    process_one(dest, rxbuf, nrx, origin);
-    return true;
+    // a full batch suggests more are waiting
+    return size_t(nrx)==nmsg;
 }
 
 void UDPCollector::process_one(const SockAddr &dest, const uint8_t *buf, size_t nrx, origin_t origin)
@@ -323,7 +354,7 @@ void UDPCollector::process_one(const SockAddr &dest, const uint8_t *buf, size_t
             // invalid, bcast, or not ipv4
 
         } else if(dest.compare(lo_mcast_addr.addr,false)!=0) {
-            assert(buf==&this->buf[cmd_origin_tag_size]);
+            assert(is_slot(buf));
             // clear unicast flag in forwarded message
             *save_flags &= ~pva_search_flags::Unicast;
             // recipient of forwarded message must use, and trust, replyAddr in body :(
@@ -375,7 +406,11 @@ void UDPCollector::process_one(const SockAddr &dest, const uint8_t *buf, size_t
             // inject nil for previous PV name
             *mundge = '\0';
             if(protoTCP && chlen.size<=M.size() && M.good()) {
-                names.push_back(UDPManager::Search::Name{reinterpret_cast<const char*>(M.save()), id});
+                // hash once here for all listeners, and all Sources of each
+                auto name = reinterpret_cast<const char*>(M.save());
+                // an embedded nil truncates
+                size_t len = std::find(name, name+chlen.size, '\0') - name;
+                names.push_back(UDPManager::Search::Name{name, id, len, nameHash(name, len)});
             }
             M.skip(chlen.size, __FILE__, __LINE__);
         }
@@ -464,21 +499,22 @@ void UDPCollector::forwardM(const SockAddr& origin, const uint8_t *pbuf, size_t
     log_debug_printf(logio, "Forward as originated for %s\n",
                      origin.tostring().c_str());
 
-    assert(buf.size() > cmd_origin_tag_size);
-    assert(pbuf==&buf[cmd_origin_tag_size]);
+    assert(is_slot(pbuf));
+    // prefix space precedes each RX slot
+    auto prefix = const_cast<uint8_t*>(pbuf) - cmd_origin_tag_size;
 
     {
-        FixedBuf M(true, &buf[0], cmd_origin_tag_size);
+        FixedBuf M(true, prefix, cmd_origin_tag_size);
 
         to_wire(M, Header{CMD_ORIGIN_TAG, 0, 16u});
         to_wire(M, origin);
         assert(M.good());
-        assert(M.save()==&buf[cmd_origin_tag_size]);
+        assert(M.save()==pbuf);
     }
 
     sock.mcast_prep_sendto(lo_mcast_addr);
     src = lo_mcast_addr.addr;
-    reply(&buf[0], cmd_origin_tag_size+plen);
+    reply(prefix, cmd_origin_tag_size+plen);
 }
 
 bool UDPCollector::reply(const void *msg, size_t msglen) const
@@ -58,6 +58,8 @@ struct PVXS_API UDPManager
         struct Name {
             const char *name;
             uint32_t id;
+            size_t len;    // strlen(name)
+            uint64_t hash; // nameHash(name, len)
         };
 
         std::vector<Name> names;
@@ -115,6 +117,10 @@ public:
     inline void stop() { start(false); }
 };
 
+//! Max. number of UDP datagrams received with one system call.
+//! From $PVXS_UDP_BATCH, default 4.  (in config.cpp)
+size_t udpRxBatch();
+
 }} // namespace pvxs::impl
 
 #endif // UDP_COLLECTOR_H
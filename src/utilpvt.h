@@ -18,9 +18,11 @@
 #  include <pthread.h>
 #endif
 
+#include <cstring>
 #include <atomic>
 #include <memory>
 #include <set>
+#include <vector>
 #include <string>
 #include <sstream>
 #include <type_traits>
@@ -249,6 +251,236 @@ template <size_t Len, typename... Types>
 using aligned_union = std::aligned_union<Len, Types...>;
 #endif
 
+/** FIFO queue stored in a contiguous ring of pre-allocated slots.
+ *
+ * Capacity is set up front with reserve(), and thereafter only grows (doubling)
+ * if a push_back() finds the ring full.  So steady state push_back()/pop_front()
+ * never allocate, unlike std::deque which allocates a new node every few entries.
+ *
+ * Vacated slots are reset to T{} so that references are released promptly.
+ * Not thread-safe.  Access must be externally serialized.
+ */
+template<typename T>
+class RingQueue {
+    std::vector<T> slots; // size() is zero or a power of two
+    size_t head = 0u;
+    size_t count = 0u;
+
+    inline size_t wrap(size_t i) const { return i & (slots.size()-1u); }
+
+    void grow(size_t minCap) {
+        size_t cap = 4u;
+        while(cap < minCap)
+            cap <<= 1u;
+        std::vector<T> next(cap);
+        for(size_t i=0u; i<count; i++)
+            next[i] = std::move(slots[wrap(head+i)]);
+        slots.swap(next);
+        head = 0u;
+    }
+public:
+    RingQueue() = default;
+    RingQueue(const RingQueue&) = delete;
+    RingQueue& operator=(const RingQueue&) = delete;
+
+    inline size_t size() const { return count; }
+    inline bool empty() const { return !count; }
+    inline size_t capacity() const { return slots.size(); }
+
+    //! Ensure that at least n entries may be held without allocation
+    void reserve(size_t n) {
+        if(n > slots.size())
+            grow(n);
+    }
+
+    inline T& front() { return slots[head]; }
+    inline const T& front() const { return slots[head]; }
+    inline T& back() { return slots[wrap(head+count-1u)]; }
+    inline const T& back() const { return slots[wrap(head+count-1u)]; }
+
+    void push_back(T&& v) {
+        if(count==slots.size())
+            grow(count+1u);
+        slots[wrap(head+count)] = std::move(v);
+        count++;
+    }
+
+    template<typename... Args>
+    inline void emplace_back(Args&&... args) {
+        push_back(T(std::forward<Args>(args)...));
+    }
+
+    void pop_front() {
+        slots[head] = T();
+        head = wrap(head+1u);
+        count--;
+    }
+
+    void clear() {
+        while(count)
+            pop_front();
+        head = 0u;
+    }
+};
+
+//! 64-bit FNV-1a hash of a (PV) name
+inline
+uint64_t nameHash(const char* name, size_t len)
+{
+    uint64_t H = 0xcbf29ce484222325ull;
+    for(size_t i=0u; i<len; i++) {
+        H ^= uint8_t(name[i]);
+        H *= 0x100000001b3ull;
+    }
+    return H;
+}
+
+inline
+uint64_t nameHash(const std::string& name) { return nameHash(name.data(), name.size()); }
+
+/** Map of (PV) names to values in a flat, open addressed, hash table.
+ *
+ * Hashes are kept in a separate contiguous array, so a probe compares
+ * hashes before touching any string.  Lookups may pass a precomputed nameHash().
+ * Iteration order is arbitrary.
+ * Not thread-safe.  Access must be externally serialized.
+ */
+template<typename V>
+class NameIndex {
+public:
+    typedef std::pair<std::string, V> value_type;
+private:
+    // 0 - empty, 1 - erased.  Stored hashes are never 0 or 1.
+    std::vector<uint64_t> hashes; // size() is zero or a power of two
+    std::vector<value_type> entries;
+    size_t nfull = 0u;
+    size_t nused = 0u; // nfull + erased
+
+    static inline uint64_t fix(uint64_t h) { return h<2u ? h+2u : h; }
+    inline size_t first(uint64_t h) const { return size_t(h ^ (h>>32u)) & (hashes.size()-1u); }
+    inline size_t next(size_t i) const { return (i+1u) & (hashes.size()-1u); }
+
+    // index of key, or hashes.size() if not present
+    size_t lookup(const char* key, size_t len, uint64_t h) const {
+        if(hashes.empty())
+            return 0u;
+        h = fix(h);
+        // load factor <= 0.5, so always terminates at an empty slot
+        for(size_t i=first(h); ; i=next(i)) {
+            auto cur = hashes[i];
+            if(cur==0u)
+                return hashes.size();
+            auto& ent = entries[i].first;
+            if(cur==h && ent.size()==len && memcmp(ent.data(), key, len)==0)
+                return i;
+        }
+    }
+
+    void rehash(size_t cap) {
+        std::vector<uint64_t> oldh(cap, 0u);
+        std::vector<value_type> olde(cap);
+        oldh.swap(hashes);
+        olde.swap(entries);
+        nused = nfull;
+        for(size_t i=0u; i<oldh.size(); i++) {
+            if(oldh[i]<2u)
+                continue;
+            size_t j=first(oldh[i]);
+            while(hashes[j])
+                j = next(j);
+            hashes[j] = oldh[i];
+            entries[j] = std::move(olde[i]);
+        }
+    }
+public:
+    inline size_t size() const { return nfull; }
+    inline bool empty() const { return !nfull; }
+
+    //! Ensure that n entries may be held without rehashing
+    void reserve(size_t n) {
+        size_t cap = 8u;
+        while(cap < 2u*n)
+            cap <<= 1u;
+        if(cap > hashes.size())
+            rehash(cap);
+    }
+
+    V* find(const char* key, size_t len, uint64_t h) {
+        auto i = lookup(key, len, h);
+        return i<hashes.size() ? &entries[i].second : nullptr;
+    }
+    inline const V* find(const char* key, size_t len, uint64_t h) const {
+        return const_cast<NameIndex*>(this)->find(key, len, h);
+    }
+    inline V* find(const std::string& key) {
+        return find(key.data(), key.size(), nameHash(key));
+    }
+    inline const V* find(const std::string& key) const {
+        return find(key.data(), key.size(), nameHash(key));
+    }
+
+    //! Insert if not already present.
+    //! @returns The value for key, and true if inserted
+    std::pair<V*, bool> insert(const std::string& key, const V& val) {
+        const auto h(nameHash(key));
+        if(auto prev = find(key.data(), key.size(), h))
+            return std::make_pair(prev, false);
+
+        if(2u*(nused+1u) > hashes.size()) // also cleans out erased
+        {
+            size_t cap = 8u;
+            while(cap < 4u*(nfull+1u))
+                cap <<= 1u;
+            rehash(cap);
+        }
+
+        const auto fh(fix(h));
+        size_t i=first(fh);
+        while(hashes[i]>=2u)
+            i = next(i);
+        if(hashes[i]==0u)
+            nused++;
+        hashes[i] = fh;
+        entries[i].first = key;
+        entries[i].second = val;
+        nfull++;
+        return std::make_pair(&entries[i].second, true);
+    }
+
+    //! @returns true if key was present
+    bool erase(const std::string& key) {
+        auto i = lookup(key.data(), key.size(), nameHash(key));
+        if(i>=hashes.size())
+            return false;
+        hashes[i] = 1u;
+        entries[i] = value_type();
+        nfull--;
+        return true;
+    }
+
+    void clear() {
+        hashes.clear();
+        entries.clear();
+        nfull = nused = 0u;
+    }
+
+    //! Call fn(const std::string& key, V& value) for each entry
+    template<typename Fn>
+    void visit(Fn&& fn) {
+        for(size_t i=0u; i<hashes.size(); i++) {
+            if(hashes[i]>=2u)
+                fn(entries[i].first, entries[i].second);
+        }
+    }
+    template<typename Fn>
+    void visit(Fn&& fn) const {
+        for(size_t i=0u; i<hashes.size(); i++) {
+            if(hashes[i]>=2u)
+                fn(entries[i].first, entries[i].second);
+        }
+    }
+};
+
 } // namespace impl
 using namespace impl;
 
@@ -8,23 +8,169 @@
 #include <vector>
 #include <ostream>
 #include <algorithm>
+#include <deque>
+#include <set>
+#include <map>
+#include <thread>
+#include <atomic>
+#include <new>
+#include <cstdlib>
+
+#if defined(__GLIBC__) && (__GLIBC__>2 || (__GLIBC__==2 && __GLIBC_MINOR__>=33))
+#  include <malloc.h>
+#  define HAVE_MALLINFO2
+#endif
 
 #include <pvxs/data.h>
 #include <pvxs/nt.h>
+#include <pvxs/server.h>
+#include <pvxs/sharedpv.h>
+#include <pvxs/client.h>
 #include <pvxs/unittest.h>
 
 #include "pvaproto.h"
+#include "dataimpl.h"
 #include <utilpvt.h>
 
 #include <evhelper.h>
 
 #include <epicsTime.h>
+#include <epicsEvent.h>
 #include <epicsUnitTest.h>
 #include <testMain.h>
 
 namespace {
 using namespace pvxs;
 
+std::atomic<size_t> nAlloc{0u};
+
+} // namespace
+
+// count allocations.  Every replaceable form of operator new/delete is
+// replaced, so that each delete matches the allocator of its new.
+// The helpers are not inlined so that gcc does not pair the free() with
+// a (replaced) operator new and warn with -Wmismatched-new-delete
+#if defined(__GNUC__)
+#  define NOINLINE __attribute__((noinline))
+#else
+#  define NOINLINE
+#endif
+
+namespace {
+
+NOINLINE
+void* countedAlloc(size_t size)
+{
+    nAlloc.fetch_add(1u, std::memory_order_relaxed);
+    return malloc(size ? size : 1u);
+}
+
+NOINLINE
+void countedFree(void* ptr) noexcept
+{
+    free(ptr);
+}
+
+#ifdef __cpp_aligned_new
+NOINLINE
+void* countedAlloc(size_t size, std::align_val_t align)
+{
+    nAlloc.fetch_add(1u, std::memory_order_relaxed);
+    size_t alignment(static_cast<size_t>(align));
+    if(alignment < sizeof(void*))
+        alignment = sizeof(void*);
+#ifdef _WIN32
+    return _aligned_malloc(size ? size : 1u, alignment);
+#else
+    void* ret = nullptr;
+    if(posix_memalign(&ret, alignment, size ? size : 1u))
+        ret = nullptr;
+    return ret;
+#endif
+}
+
+NOINLINE
+void countedFree(void* ptr, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+#endif // __cpp_aligned_new
+
+} // namespace
+
+void* operator new(size_t size)
+{
+    if(auto ret = countedAlloc(size))
+        return ret;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+    if(auto ret = countedAlloc(size))
+        return ret;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+
+void operator delete(void* ptr) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr) noexcept { countedFree(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { countedFree(ptr); }
+
+#ifdef __cpp_sized_deallocation
+void operator delete(void* ptr, size_t) noexcept { countedFree(ptr); }
+void operator delete[](void* ptr, size_t) noexcept { countedFree(ptr); }
+#endif
+
+#ifdef __cpp_aligned_new
+void* operator new(size_t size, std::align_val_t align)
+{
+    if(auto ret = countedAlloc(size, align))
+        return ret;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t align)
+{
+    if(auto ret = countedAlloc(size, align))
+        return ret;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size, align);
+}
+
+void* operator new[](size_t size, std::align_val_t align, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size, align);
+}
+
+void operator delete(void* ptr, std::align_val_t align) noexcept { countedFree(ptr, align); }
+void operator delete[](void* ptr, std::align_val_t align) noexcept { countedFree(ptr, align); }
+void operator delete(void* ptr, std::align_val_t align, const std::nothrow_t&) noexcept { countedFree(ptr, align); }
+void operator delete[](void* ptr, std::align_val_t align, const std::nothrow_t&) noexcept { countedFree(ptr, align); }
+void operator delete(void* ptr, size_t, std::align_val_t align) noexcept { countedFree(ptr, align); }
+void operator delete[](void* ptr, size_t, std::align_val_t align) noexcept { countedFree(ptr, align); }
+#endif // __cpp_aligned_new
+
+namespace {
+
 struct Sampler
 {
     size_t nsamp =0;
@@ -85,19 +231,44 @@ void benchAllocNTScalar()
 
     const Value prototype(nt::NTScalar{TypeCode::UInt64, true, true, true}.create());
 
-    std::vector<Value> can(niter);
+    {
+        std::vector<Value> can(niter);
 
-    Sampler S;
+        Sampler S;
 
-    for(auto n : range(niter)) {
-        StopWatch W;
+        for(auto n : range(niter)) {
+            StopWatch W;
 
-        (void)W.click();
-        can[n] = prototype.cloneEmpty();
-        S.sample(W.click());
+            (void)W.click();
+            can[n] = prototype.cloneEmpty();
+            S.sample(W.click());
+        }
+
+        testShow()<<S;
     }
 
-    testShow()<<S;
+    // create, fill, and release, as for a post()'d update
+    ValuePool pool(prototype, 4u);
+    for(auto usePool : {false, true}) {
+        Sampler S;
+        size_t nalloc = 0u;
+
+        for(auto n : range(niter)) {
+            StopWatch W;
+
+            auto before = nAlloc.load();
+            (void)W.click();
+            {
+                auto val(usePool ? pool.create() : prototype.cloneEmpty());
+                val["value"] = n;
+            }
+            S.sample(W.click());
+            nalloc += nAlloc.load() - before;
+        }
+
+        testShow()<<(usePool ? " ValuePool " : " cloneEmpty ")<<S<<"\n"
+                    " "<<double(nalloc)/niter<<" allocations/Value";
+    }
 }
 
 template<typename E>
@@ -144,12 +315,301 @@ void benchArraySerDes(bool be, const shared_array<const E>& arr)
     testShow()<<" Des "<<Tdes;
 }
 
+void benchBSwap(size_t esize, size_t nelem)
+{
+    testDiag("%s() esize=%u nelem=%u", __func__, unsigned(esize), unsigned(nelem));
+
+    constexpr size_t niter = 1000u;
+
+    std::vector<uint8_t> src(esize*nelem), dest(esize*nelem);
+    for(auto i : range(src.size()))
+        src[i] = uint8_t(i);
+
+    Sampler S;
+    StopWatch W;
+
+    // baseline
+    for(auto n : range(niter)) {
+        (void)n;
+        (void)W.click();
+        memcpy(dest.data(), src.data(), src.size());
+        S.sample(W.click());
+    }
+    testShow()<<" memcpy "<<S;
+
+    for(auto& K : impl::bswap_kernels()) {
+        auto fn = esize==2u ? K.swap2 : esize==4u ? K.swap4 : K.swap8;
+        S.reset();
+
+        for(auto n : range(niter)) {
+            (void)n;
+            (void)W.click();
+            (*fn)(dest.data(), src.data(), nelem);
+            S.sample(W.click());
+        }
+        testShow()<<" "<<K.name<<" "<<S;
+    }
+}
+
+
+template<typename Q>
+void benchQueueContainer(const char* name, size_t depth)
+{
+    constexpr size_t niter = 1000u;
+
+    Value proto(nt::NTScalar{TypeCode::Int32}.create());
+    Q queue;
+
+    Sampler S;
+    StopWatch W;
+
+    for(auto n : range(niter)) {
+        (void)n;
+        (void)W.click();
+        for(auto i : range(depth)) {
+            (void)i;
+            queue.push_back(Value(proto));
+        }
+        while(!queue.empty()) {
+            Value temp(std::move(queue.front()));
+            queue.pop_front();
+        }
+        S.sample(W.click());
+    }
+    testShow()<<" "<<name<<" "<<S;
+}
+
+// post() -> network -> pop() through loopback
+void benchMonitorThroughput(uint32_t queueSize)
+{
+    testDiag("%s() queueSize=%u", __func__, unsigned(queueSize));
+
+    constexpr int32_t nupdate = 100000;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    initial["value"] = -1;
+    auto mbox(server::SharedPV::buildReadonly());
+    mbox.open(initial);
+
+    auto serv(server::Config::isolated().build()
+              .addPV("mailbox", mbox)
+              .start());
+    auto cli(serv.clientConfig().build());
+
+    epicsEvent evt;
+    auto sub(cli.monitor("mailbox")
+             .record("queueSize", queueSize)
+             .event([&evt](client::Subscription&) { evt.signal(); })
+             .exec());
+
+    // wait for initial update
+    while(true) {
+        if(auto val = sub->pop())
+            break;
+        else if(!evt.wait(5.0))
+            testAbort("timeout waiting for initial update");
+    }
+
+    StopWatch W;
+    (void)W.click();
+
+    std::thread poster([&mbox, &initial]() {
+        for(int32_t i=0; i<nupdate; i++) {
+            auto update(initial.cloneEmpty());
+            update["value"] = i;
+            mbox.post(update);
+        }
+    });
+
+    size_t nrx = 0u;
+    int32_t last = -1;
+    while(last!=nupdate-1) {
+        if(auto val = sub->pop()) {
+            last = val["value"].as<int32_t>();
+            nrx++;
+        } else if(!evt.wait(5.0)) {
+            testAbort("timeout waiting for update");
+        }
+    }
+    auto elapsed = W.click();
+    poster.join();
+
+    client::SubscriptionStat stat;
+    sub->stats(stat);
+
+    testShow()<<" posted "<<nupdate<<" received "<<nrx
+              <<" in "<<elapsed/1e6<<" ms -> "<<nrx/(elapsed/1e9)<<" updates/s"
+              <<" maxQueue="<<stat.maxQueue;
+
+    sub.reset();
+    cli.close();
+    serv.stop();
+}
+
+// search-like lookups of names, half of which are present
+void benchNameLookup(size_t nname)
+{
+    testDiag("%s() nname=%u", __func__, unsigned(nname));
+
+    constexpr size_t nlookup = 100000u;
+
+    std::vector<std::string> names(nname);
+    for(auto i : range(nname)) {
+        names[i] = SB()<<"SITE:SYS"<<(i%97u)<<":DEV"<<i<<":Readback";
+    }
+    std::vector<std::string> query(nlookup);
+    std::vector<uint64_t> qhash(nlookup);
+    for(auto i : range(nlookup)) {
+        auto n = (i*7919u)%nname;
+        query[i] = (i%2u) ? names[n] : names[n]+"X";
+        qhash[i] = nameHash(query[i]);
+    }
+
+    std::set<std::string> set(names.begin(), names.end());
+    std::map<std::string, size_t> map;
+    NameIndex<size_t> index;
+    index.reserve(nname);
+    for(auto i : range(nname)) {
+        map[names[i]] = i;
+        index.insert(names[i], i);
+    }
+
+    StopWatch W;
+    size_t nfound = 0u;
+
+    (void)W.click();
+    for(auto& name : query)
+        nfound += set.count(name.c_str());
+    auto tset = W.click();
+
+    for(auto& name : query)
+        nfound += map.find(name.c_str())!=map.end();
+    auto tmap = W.click();
+
+    for(auto& name : query)
+        nfound += !!index.find(name.c_str(), strlen(name.c_str()), nameHash(name.c_str(), strlen(name.c_str())));
+    auto tindex = W.click();
+
+    for(auto i : range(nlookup))
+        nfound += !!index.find(query[i].c_str(), query[i].size(), qhash[i]);
+    auto tprehash = W.click();
+
+    testOk(nfound==2u*nlookup, "found %u", unsigned(nfound));
+    testShow()<<" std::set           "<<double(tset)/nlookup<<" ns/lookup\n"
+                " std::map           "<<double(tmap)/nlookup<<" ns/lookup\n"
+                " NameIndex          "<<double(tindex)/nlookup<<" ns/lookup\n"
+                " NameIndex pre-hash "<<double(tprehash)/nlookup<<" ns/lookup";
+}
+
+void benchFieldPath()
+{
+    testDiag("%s", __func__);
+
+    constexpr size_t niter = 1000000u;
+
+    const Value prototype(nt::NTScalar{TypeCode::Float64, true, true, true}.create());
+    Value val(prototype.cloneEmpty());
+
+    const FieldPath value(prototype, "value");
+    const FieldPath secs(prototype, "timeStamp.secondsPastEpoch");
+
+    StopWatch W;
+    int64_t sum = 0;
+
+    (void)W.click();
+    for(auto i : range(niter)) {
+        val["value"] = double(i);
+        val["timeStamp.secondsPastEpoch"] = int64_t(i);
+        sum += val["timeStamp.secondsPastEpoch"].as<int64_t>();
+    }
+    auto texpr = W.click();
+
+    for(auto i : range(niter)) {
+        val[value] = double(i);
+        val[secs] = int64_t(i);
+        sum += val[secs].as<int64_t>();
+    }
+    auto tpath = W.click();
+
+    testOk(sum==int64_t(niter)*int64_t(niter-1u), "sum %lld", (long long)sum);
+    testShow()<<" expression "<<double(texpr)/niter/3u<<" ns/access\n"
+                " FieldPath  "<<double(tpath)/niter/3u<<" ns/access";
+}
+
+// bytes of heap currently allocated, if known
+size_t heapInUse()
+{
+#ifdef HAVE_MALLINFO2
+    auto info(mallinfo2());
+    return info.uordblks + info.hblkhd;
+#else
+    return 0u;
+#endif
+}
+
+void benchTypeIndex(const char* name, const TypeDef& def, const std::string& field)
+{
+    testDiag("%s() %s", __func__, name);
+
+    constexpr size_t niter = 100u;
+    constexpr size_t nlookup = 1000000u;
+
+    std::vector<uint8_t> buf(1u<<20u);
+    size_t blen;
+    {
+        auto val(def.create());
+        FixedBuf S(true, buf);
+        to_wire(S, Value::Helper::desc(val));
+        testOk1(S.good());
+        blen = S.save() - buf.data();
+    }
+
+    std::vector<std::vector<impl::FieldDesc>> descs(niter);
+    StopWatch W;
+
+    auto heap0 = heapInUse();
+    (void)W.click();
+    for(auto& desc : descs) {
+        TypeStore cache;
+        FixedBuf R(true, buf.data(), blen);
+        from_wire(R, desc, cache);
+        if(!R.good())
+            testAbort("decode error");
+    }
+    auto tdecode = W.click();
+    auto heap1 = heapInUse();
+
+    auto& desc = descs.front();
+    size_t nfound = 0u;
+    (void)W.click();
+    for(auto i : range(nlookup)) {
+        (void)i;
+        nfound += desc[0].mlookup.find(field)!=desc[0].mlookup.end();
+    }
+    auto tlookup = W.click();
+
+    testEq(nfound, nlookup);
+    testShow()<<" "<<desc.size()<<" nodes, "<<desc[0].mlookup.size()<<" names\n"
+                " decode "<<double(tdecode)/niter*1e-3<<" us/type\n"
+                " memory "<<double(heap1-heap0)/niter<<" bytes/type\n"
+                " lookup '"<<field<<"' "<<double(tlookup)/nlookup<<" ns";
+}
+
 } // namespace
 
 MAIN(benchdata)
 {
     testPlan(0);
     benchAllocNTScalar();
+    benchFieldPath();
+    benchTypeIndex("NTNDArray", nt::NTNDArray{}.build(), "timeStamp.nanoseconds");
+    {
+        nt::NTTable table;
+        for(auto i : range(1000u)) {
+            table.add_column(TypeCode::Float64, std::string(SB()<<"column"<<i).c_str());
+        }
+        benchTypeIndex("NTTable 1000 columns", table.build(), "value.column500");
+    }
 
     constexpr size_t nelem = 10000u;
     testDiag("test optimization for fixed size (POD) elements");
@@ -162,6 +622,10 @@ MAIN(benchdata)
         benchArraySerDes<uint64_t>(hostBE, arr);
         benchArraySerDes<uint64_t>(!hostBE, arr);
     }
+    testDiag("byte swap kernels.  Last is used for (de)serialization");
+    for(size_t esize : {2u, 4u, 8u}) {
+        benchBSwap(esize, nelem);
+    }
     testDiag("baseline unoptimized for a variable size element");
     {
         shared_array<std::string> temp(nelem);
@@ -172,5 +636,18 @@ MAIN(benchdata)
         benchArraySerDes<std::string>(hostBE, arr);
         benchArraySerDes<std::string>(!hostBE, arr);
     }
+    testDiag("monitor queue containers.  push then pop a full queue");
+    for(size_t depth : {4u, 64u}) {
+        testDiag("depth=%u", unsigned(depth));
+        benchQueueContainer<std::deque<Value>>("deque", depth);
+        benchQueueContainer<RingQueue<Value>>("RingQueue", depth);
+    }
+    for(uint32_t queueSize : {4u, 64u}) {
+        benchMonitorThroughput(queueSize);
+    }
+    testDiag("PV name lookup.  Current vs. hash index");
+    for(size_t nname : {1000u, 100000u, 500000u}) {
+        benchNameLookup(nname);
+    }
     return testDone();
 }
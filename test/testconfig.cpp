@@ -82,11 +82,19 @@ void testDefs()
         conf.interfaces = {"1.2.3.4", "1.1.1.1"};
         conf.addressList = {"1.2.1.2", "4.3.2.1:1234"};
         conf.autoAddrList = false;
+        conf.tcpWorkers = 2u;
+        conf.tcpSegmentSize = 4096u;
+        conf.tcpReserveMax = 1048576u;
+        conf.createBatch = 100u;
         conf.updateDefs(defs);
         testEq(defs["EPICS_PVA_BROADCAST_PORT"], "1234");
         testEq(defs["EPICS_PVA_AUTO_ADDR_LIST"], "NO");
         testEq(defs["EPICS_PVA_ADDR_LIST"], "1.2.1.2 4.3.2.1:1234");
         testEq(defs["EPICS_PVA_INTF_ADDR_LIST"], "1.2.3.4 1.1.1.1");
+        testEq(defs["EPICS_PVA_TCP_WORKERS"], "2");
+        testEq(defs["EPICS_PVA_TCP_SEGMENT_SIZE"], "4096");
+        testEq(defs["EPICS_PVA_TCP_RESERVE_MAX"], "1048576");
+        testEq(defs["EPICS_PVA_CREATE_BATCH"], "100");
     }
 
     {
@@ -97,11 +105,30 @@ void testDefs()
         defs["EPICS_PVA_AUTO_ADDR_LIST"] = "NO";
         defs["EPICS_PVA_ADDR_LIST"] = "1.2.1.2 4.3.2.1:1234";
         defs["EPICS_PVA_INTF_ADDR_LIST"] = "1.2.3.4 1.1.1.1";
+        defs["EPICS_PVA_TCP_WORKERS"] = "2";
+        defs["EPICS_PVA_TCP_SEGMENT_SIZE"] = "4096";
+        defs["EPICS_PVA_CREATE_BATCH"] = "100000";
         conf.applyDefs(defs);
         testEq(conf.udp_port, 1234);
         testFalse(conf.autoAddrList);
         testEq(conf.addressList, std::vector<std::string>({"1.2.1.2:1234", "4.3.2.1:1234"}));
         testEq(conf.interfaces, std::vector<std::string>({"1.1.1.1", "1.2.3.4"}));
+        testEq(conf.tcpWorkers, 2u);
+        testEq(conf.tcpSegmentSize, 4096u);
+        testEq(conf.createBatch, 100000u);
+        conf.autoAddrList = false;
+        conf.interfaces.clear();
+        conf.addressList.clear();
+        conf.expand();
+        testEq(conf.createBatch, 0xffffu)<<" maximum";
+        conf.createBatch = 0u;
+        conf.expand();
+        testEq(conf.createBatch, 1u)<<" minimum";
+
+        defs.clear();
+        defs["EPICS_PVA_CREATE_BATCH"] = "4294967396"; // 2**32 + 100
+        conf.applyDefs(defs);
+        testEq(conf.createBatch, 1u)<<" out of range ignored";
     }
 
     {
@@ -113,6 +140,10 @@ void testDefs()
         conf.interfaces = {"1.2.3.4", "1.1.1.1"};
         conf.beaconDestinations = {"1.2.1.2", "4.3.2.1:1234"};
         conf.auto_beacon = false;
+        conf.tcpWorkers = 4u;
+        conf.tcpSegmentSize = 8192u;
+        conf.tcpFlushDelay = 500u;
+        conf.tcpFlushBytes = 4096u;
 
         conf.updateDefs(defs);
         testEq(defs["EPICS_PVA_BROADCAST_PORT"], "1234");
@@ -125,6 +156,10 @@ void testDefs()
         testEq(defs["EPICS_PVAS_BEACON_ADDR_LIST"], "1.2.1.2 4.3.2.1:1234");
         testEq(defs["EPICS_PVA_INTF_ADDR_LIST"], "1.2.3.4 1.1.1.1");
         testEq(defs["EPICS_PVAS_INTF_ADDR_LIST"], "1.2.3.4 1.1.1.1");
+        testEq(defs["EPICS_PVAS_TCP_WORKERS"], "4");
+        testEq(defs["EPICS_PVAS_TCP_SEGMENT_SIZE"], "8192");
+        testEq(defs["EPICS_PVAS_TCP_FLUSH_DELAY"], "500");
+        testEq(defs["EPICS_PVAS_TCP_FLUSH_BYTES"], "4096");
     }
 
     {
@@ -136,12 +171,66 @@ void testDefs()
         defs["EPICS_PVAS_AUTO_BEACON_ADDR_LIST"] = "NO";
         defs["EPICS_PVAS_BEACON_ADDR_LIST"] = "1.2.1.2 4.3.2.1:1234";
         defs["EPICS_PVAS_INTF_ADDR_LIST"] = "1.2.3.4 1.1.1.1";
+        defs["EPICS_PVAS_TCP_WORKERS"] = "4";
+        defs["EPICS_PVAS_TCP_SEGMENT_SIZE"] = "10";
+        defs["EPICS_PVAS_TCP_RESERVE_MAX"] = "8589934592"; // 2**33
+        defs["EPICS_PVAS_TCP_FLUSH_DELAY"] = "2000000";
+        defs["EPICS_PVAS_TCP_FLUSH_BYTES"] = "0";
         conf.applyDefs(defs);
         testEq(conf.udp_port, 1234);
         testEq(conf.tcp_port, 5678);
         testFalse(conf.auto_beacon);
         testEq(conf.beaconDestinations, std::vector<std::string>({"1.2.1.2:1234", "4.3.2.1:1234"}));
         testEq(conf.interfaces, std::vector<std::string>({"1.1.1.1:5678", "1.2.3.4:5678"}));
+        testEq(conf.tcpWorkers, 4u);
+        testEq(conf.tcpSegmentSize, 10u);
+        testEq(conf.tcpReserveMax, 0xffffffffu);
+        testEq(conf.tcpFlushDelay, 2000000u);
+        testEq(conf.tcpFlushBytes, 0u);
+        conf.expand();
+        testEq(conf.tcpSegmentSize, 1024u)<<" minimum";
+        testEq(conf.tcpFlushDelay, 1000000u)<<" maximum";
+        testEq(conf.tcpFlushBytes, 16384u)<<" default";
+    }
+
+    {
+        server::Config::defs_t defs;
+        server::Config conf;
+        conf.tcpWorkers = 4u;
+
+        defs["EPICS_PVAS_TCP_WORKERS"] = "4294967297"; // 2**32 + 1
+        conf.applyDefs(defs);
+        testEq(conf.tcpWorkers, 4u)<<" out of range ignored";
+
+        defs["EPICS_PVAS_TCP_WORKERS"] = "100000";
+        conf.applyDefs(defs);
+        testEq(conf.tcpWorkers, 100000u);
+        conf.auto_beacon = false;
+        conf.expand();
+        testEq(conf.tcpWorkers, 256u)<<" maximum";
+
+        client::Config cconf;
+        cconf.tcpWorkers = 100000u;
+        cconf.autoAddrList = false;
+        cconf.expand();
+        testEq(cconf.tcpWorkers, 256u)<<" maximum";
+    }
+
+    {
+        server::Config::defs_t defs;
+        server::Config conf;
+        conf.auto_beacon = false;
+
+        defs["EPICS_PVAS_TCP_FLUSH_DELAY"] = "4294967396"; // 2**32 + 100
+        conf.applyDefs(defs);
+        testEq(conf.tcpFlushDelay, 0xffffffffu)<<" saturated, not wrapped";
+        conf.expand();
+        testEq(conf.tcpFlushDelay, 1000000u)<<" maximum";
+
+        defs["EPICS_PVAS_TCP_FLUSH_DELAY"] = "1000";
+        conf.applyDefs(defs);
+        conf.expand();
+        testEq(conf.tcpFlushDelay, 1000u);
     }
 }
 
@@ -179,7 +268,7 @@ void testClientAuto()
 
 MAIN(testconfig)
 {
-    testPlan(31);
+    testPlan(60);
     testSetup();
     testDefs();
     logger_config_env();
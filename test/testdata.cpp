@@ -47,6 +47,93 @@ void testTraverse()
     testFalse(top.equalType(top["value"]));
 }
 
+void testFieldPath()
+{
+    testDiag("%s", __func__);
+
+    const Value proto(nt::NTScalar{TypeCode::Int32, true}.create());
+
+    const FieldPath value(proto, "value");
+    const FieldPath secs(proto, "timeStamp.secondsPastEpoch");
+    const FieldPath sevr(proto["alarm"], "status<severity");
+    testTrue(value.fixed());
+    testTrue(secs.fixed());
+    testTrue(sevr.fixed());
+    testEq(secs.expr(), "timeStamp.secondsPastEpoch");
+
+    testThrows<LookupError>([&proto](){
+        FieldPath(proto, "nonexistent");
+    });
+
+    auto val(proto.cloneEmpty());
+    val[value] = 42;
+    val[secs] = 1234;
+    val["alarm"][sevr] = 2;
+    testEq(val["value"].as<int32_t>(), 42);
+    testTrue(val[secs].equalInst(val["timeStamp.secondsPastEpoch"]));
+    testEq(val.lookup(secs).as<int64_t>(), 1234);
+    testEq(val["alarm.severity"].as<int32_t>(), 2);
+    testTrue(val["value"].isMarked());
+
+    // same structure, different type instance.  Expression is parsed
+    auto other(nt::NTScalar{TypeCode::Int32, true}.create());
+    other[secs] = 5;
+    testEq(other["timeStamp.secondsPastEpoch"].as<int64_t>(), 5);
+
+    // different base
+    testFalse(val["alarm"][secs].valid());
+    testThrows<LookupError>([&val, &secs](){
+        val["alarm"].lookup(secs);
+    });
+    testFalse(Value()[secs].valid());
+
+    // traversing a Union is never fixed
+    const Value uproto(TypeDef(TypeCode::Struct, {
+                                   members::Union("u", {
+                                       members::UInt16("u16"),
+                                   }),
+                               }).create());
+    const FieldPath u16(uproto, "u->u16");
+    testFalse(u16.fixed());
+    auto uval(uproto.cloneEmpty());
+    uval[u16] = 7;
+    testEq(uval["u->u16"].as<uint16_t>(), 7u);
+}
+
+void testValuePool()
+{
+    testDiag("%s", __func__);
+
+    testFalse(ValuePool().create().valid());
+
+    const Value proto(nt::NTScalar{TypeCode::String}.create());
+    ValuePool pool(proto, 2u);
+
+    const impl::FieldStorage* first;
+    {
+        auto val(pool.create());
+        testTrue(val.type()==TypeCode::Struct);
+        testTrue(val.equalType(proto));
+        testFalse(val.equalInst(proto));
+        val["value"] = "hello";
+        first = Value::Helper::store_ptr(val);
+    }
+    testEq(pool.size(), 1u);
+
+    // released storage is re-used, and cleared
+    auto A(pool.create());
+    testEq(Value::Helper::store_ptr(A), first);
+    testFalse(A.isMarked(true, true));
+    testEq(A["value"].as<std::string>(), "");
+
+    // storage in use is not re-used
+    auto B(pool.create());
+    testNotEq(Value::Helper::store_ptr(B), first);
+    auto C(pool.create());
+    testEq(pool.size(), 2u)<<" limit";
+    testNotEq(Value::Helper::store_ptr(C), Value::Helper::store_ptr(B));
+}
+
 void testAssign()
 {
     testDiag("%s", __func__);
@@ -495,9 +582,11 @@ void testClear()
 
 MAIN(testdata)
 {
-    testPlan(156);
+    testPlan(183);
     testSetup();
     testTraverse();
+    testFieldPath();
+    testValuePool();
     testAssign();
     testAssignArray();
     testAssignUnion();
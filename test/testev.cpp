@@ -7,10 +7,13 @@
 #include <testMain.h>
 
 #include <epicsUnitTest.h>
+#include <epicsEvent.h>
+#include <epicsThread.h>
 
 #include <pvxs/unittest.h>
 #include <pvxs/log.h>
 #include <evhelper.h>
+#include <pvaproto.h>
 
 using namespace pvxs;
 namespace  {
@@ -98,6 +101,114 @@ void test_call()
     testFalse(internal.tryCall([](){}));
 }
 
+void test_mfunction()
+{
+    testDiag("%s", __func__);
+
+    int called = 0;
+    auto ival(std::make_shared<int>(42));
+
+    mfunction small([&called, ival]() { called++; });
+    testTrue(small.local())<<" small stored inline";
+    testEq(ival.use_count(), 2);
+
+    char big[128] = {};
+    mfunction large([&called, big]() { called += 1 + big[0]; });
+    testFalse(large.local())<<" large stored on heap";
+
+    mfunction moved(std::move(small));
+    testTrue(!small && moved);
+    moved();
+    large();
+    testEq(called, 2);
+
+    moved = std::move(large);
+    testEq(ival.use_count(), 1)<<" previous callable destroyed";
+    moved();
+    testEq(called, 3);
+}
+
+void test_dispatch_order()
+{
+    testDiag("%s", __func__);
+
+    evbase base("TEST");
+
+    constexpr size_t nthread = 4u, nwork = 1000u;
+    std::vector<size_t> next(nthread, 0u);
+    bool inorder = true;
+
+    {
+        testDiag("Block worker to fill the inbox");
+        epicsEvent blocked, release;
+        base.dispatch([&blocked, &release]() {
+            blocked.signal();
+            release.wait();
+        });
+        blocked.wait();
+
+        for(size_t i=0u; i<nwork; i++) {
+            base.dispatch([&next, &inorder, i]() {
+                inorder &= next[0]==i;
+                next[0] = i+1u;
+            });
+        }
+        release.signal();
+        base.sync();
+        testEq(next[0], nwork);
+        testTrue(inorder);
+
+        auto stats(base.stats(true));
+        testTrue(stats.nOverflow>0u)<<" nOverflow="<<stats.nOverflow;
+        testTrue(stats.maxDepth>=nwork)<<" maxDepth="<<stats.maxDepth;
+        testEq(base.stats().nWork, 0u)<<" reset";
+    }
+
+    testDiag("Several concurrent producers");
+    next.assign(nthread, 0u);
+    {
+        std::vector<std::unique_ptr<epicsThread>> workers;
+        struct Producer : public epicsThreadRunable {
+            evbase& base;
+            std::vector<size_t>& next;
+            bool& inorder;
+            size_t idx;
+            Producer(evbase& base, std::vector<size_t>& next, bool& inorder, size_t idx)
+                :base(base), next(next), inorder(inorder), idx(idx) {}
+            virtual void run() override final {
+                for(size_t i=0u; i<nwork; i++) {
+                    auto& next = this->next;
+                    auto& inorder = this->inorder;
+                    auto idx = this->idx;
+                    base.dispatch([&next, &inorder, idx, i]() {
+                        inorder &= next[idx]==i;
+                        next[idx] = i+1u;
+                    });
+                }
+            }
+        };
+        std::vector<std::unique_ptr<Producer>> producers;
+        for(size_t t=0u; t<nthread; t++) {
+            producers.emplace_back(new Producer(base, next, inorder, t));
+            workers.emplace_back(new epicsThread(*producers.back(), "producer",
+                                                 epicsThreadGetStackSize(epicsThreadStackSmall)));
+            workers.back()->start();
+        }
+        for(auto& worker : workers)
+            worker->exitWait();
+    }
+    base.sync();
+
+    bool complete = true;
+    for(auto n : next)
+        complete &= n==nwork;
+    testTrue(complete);
+    testTrue(inorder)<<" per producer order preserved";
+    auto stats(base.stats());
+    testEq(stats.nWork, nthread*nwork+1u); // +1 for sync()
+    testTrue(stats.latencyMax>=0.0 && stats.latencyTotal>=stats.latencyMax);
+}
+
 void test_fill_evbuf()
 {
     testDiag("%s", __func__);
@@ -142,15 +253,126 @@ void test_fill_evbuf()
     testEq(evbuffer_get_length(buf.get()), 0u);
 }
 
+void test_splice_evbuf()
+{
+    testDiag("%s", __func__);
+
+    evbuf buf(__FILE__, __LINE__, evbuffer_new());
+
+    shared_array<uint32_t> arr(4096u);
+    for(auto i : range(arr.size()))
+        arr[i] = i;
+    auto carr(arr.freeze().castTo<const void>());
+
+    {
+        EvOutBuf M(hostBE, buf.get());
+        to_wire<uint32_t>(M, carr);
+        to_wire(M, uint8_t(0x42));
+        testOk1(!!M.good());
+    }
+
+    testEq(evbuffer_get_length(buf.get()), 5u + 4u*4096u + 1u);
+
+    {
+        // array storage is referenced, not copied
+        evbuffer_ptr ptr;
+        testOk1(evbuffer_ptr_set(buf.get(), &ptr, 5u, EVBUFFER_PTR_SET)==0);
+        evbuffer_iovec vec{};
+        testEq(evbuffer_peek(buf.get(), -1, &ptr, &vec, 1), 1);
+        testEq((const void*)vec.iov_base, carr.data());
+        testEq(vec.iov_len, 4u*4096u);
+    }
+
+    {
+        EvInBuf M(hostBE, buf.get());
+        shared_array<const void> out;
+        from_wire<uint32_t>(M, out);
+        uint8_t trailer = 0u;
+        from_wire(M, trailer);
+        testOk1(!!M.good());
+        auto actual(out.castTo<const uint32_t>());
+        bool match = actual.size()==4096u;
+        for(size_t i=0u; match && i<actual.size(); i++)
+            match = actual[i]==i;
+        testOk(match, "array round trip");
+        testEq(trailer, 0x42);
+    }
+
+}
+
+void test_adopt_evbuf()
+{
+    testDiag("%s", __func__);
+
+    shared_array<uint32_t> arr(4096u);
+    for(auto i : range(arr.size()))
+        arr[i] = i;
+    auto carr(arr.freeze().castTo<const void>());
+
+    shared_array<const void> out;
+    {
+        evbuf buf(__FILE__, __LINE__, evbuffer_new());
+        {
+            EvOutBuf M(hostBE, buf.get());
+            to_wire<uint32_t>(M, carr);
+            to_wire(M, uint8_t(0x42));
+            testOk1(!!M.good());
+        }
+
+        EvInBuf M(hostBE, buf.get());
+        from_wire<uint32_t>(M, out);
+        uint8_t trailer = 0u;
+        from_wire(M, trailer);
+        testOk1(!!M.good());
+        testEq(trailer, 0x42);
+    }
+    // decoded array references the original storage, and outlives the evbuffer
+    testEq(out.data(), carr.data());
+    testEq(out.size(), 4096u);
+
+    {
+        // contiguous, but array is not aligned
+        std::vector<uint8_t> raw(1u + 5u + 4u*4096u);
+        {
+            FixedBuf M(hostBE, raw);
+            to_wire(M, uint8_t(0x42));
+            to_wire<uint32_t>(M, carr);
+            testOk1(!!M.good());
+        }
+        evbuf buf(__FILE__, __LINE__, evbuffer_new());
+        evbuffer_add(buf.get(), raw.data(), raw.size());
+
+        EvInBuf M(hostBE, buf.get());
+        uint8_t header = 0u;
+        from_wire(M, header);
+        from_wire<uint32_t>(M, out);
+        testOk1(!!M.good());
+        testEq(header, 0x42);
+    }
+    // copied
+    testNotEq(out.data(), carr.data());
+    {
+        auto actual(out.castTo<const uint32_t>());
+        bool match = actual.size()==4096u;
+        for(size_t i=0u; match && i<actual.size(); i++)
+            match = actual[i]==i;
+        testOk(match, "array copied");
+    }
+}
+
 } // namespace
 
 MAIN(testev)
 {
     SockAttach attach;
-    testPlan(20);
+    testPlan(55);
     testSetup();
     test_call();
+    test_mfunction();
+    test_dispatch_order();
     test_fill_evbuf();
+    test_splice_evbuf();
+    test_adopt_evbuf();
     cleanup_for_valgrind();
     return testDone();
 }
@@ -6,12 +6,21 @@
 #define PVXS_ENABLE_EXPERT_API
 
 #include <atomic>
+#include <set>
+#include <cstring>
+
+#if defined(__GLIBC__) && (__GLIBC__>2 || (__GLIBC__==2 && __GLIBC_MINOR__>=33))
+#  include <malloc.h>
+#  define HAVE_MALLINFO2
+#endif
 
 #include <testMain.h>
 
 #include <epicsUnitTest.h>
 
 #include <epicsEvent.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
 
 #include <pvxs/unittest.h>
 #include <pvxs/log.h>
@@ -512,11 +521,440 @@ void testError(bool phase)
     }
 }
 
+void testTCPWorkers()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    auto mbox(server::SharedPV::buildReadonly());
+    initial["value"] = 42;
+    mbox.open(initial);
+
+    auto conf(server::Config::isolated());
+    conf.tcpWorkers = 3u;
+
+    auto serv = conf.build()
+            .addPV("mailbox", mbox)
+            .start();
+
+    testEq(serv.config().tcpWorkers, 3u);
+
+    // each Context makes a separate connection, to be spread across workers
+    std::vector<client::Context> clis;
+    for(size_t i=0u; i<4u; i++) {
+        clis.push_back(serv.clientConfig().build());
+    }
+
+    for(auto& cli : clis) {
+        auto val = cli.get("mailbox").exec()->wait(5.0);
+        testEq(val["value"].as<int32_t>(), 42);
+    }
+
+    // least loaded worker, lowest index first
+    {
+        auto report(serv.report());
+        std::vector<size_t> load(3u, 0u);
+        for(auto& conn : report.connections) {
+            if(conn.worker < load.size())
+                load[conn.worker]++;
+        }
+        testEq(report.connections.size(), 4u);
+        testEq(load[0], 2u);
+        testEq(load[1], 1u);
+        testEq(load[2], 1u);
+    }
+
+    // the worker of a closed connection is picked next
+    clis[1].close();
+    clis[1] = client::Context();
+    for(size_t i=0u; i<100u && serv.report().connections.size()!=3u; i++)
+        epicsThreadSleep(0.05);
+
+    clis.push_back(serv.clientConfig().build());
+    auto val = clis.back().get("mailbox").exec()->wait(5.0);
+    testEq(val["value"].as<int32_t>(), 42);
+
+    {
+        auto report(serv.report());
+        std::vector<size_t> load(3u, 0u);
+        for(auto& conn : report.connections) {
+            if(conn.worker < load.size())
+                load[conn.worker]++;
+        }
+        testEq(report.connections.size(), 4u);
+        testOk(load[0]==2u && load[1]==1u && load[2]==1u,
+               "worker load %u %u %u", unsigned(load[0]), unsigned(load[1]), unsigned(load[2]));
+    }
+}
+
+void testLargeArray(size_t nelem, size_t reserveMax = 64u*1024u*1024u)
+{
+    testShow()<<__func__<<" "<<nelem<<" "<<reserveMax;
+
+    // large enough to be received contiguously, and decoded in place
+    // (no alignment requirement for bytes)
+    shared_array<uint8_t> arr(nelem);
+    for(auto i : range(arr.size()))
+        arr[i] = uint8_t(i);
+
+    auto initial(nt::NTScalar{TypeCode::UInt8A}.create());
+    initial["value"] = arr.freeze();
+    auto mbox(server::SharedPV::buildReadonly());
+    mbox.open(initial);
+
+    auto serv = server::Config::isolated().build()
+            .addPV("mailbox", mbox)
+            .start();
+    auto conf(serv.clientConfig());
+    conf.tcpReserveMax = reserveMax;
+    auto cli = conf.build();
+
+    for(size_t n=0u; n<2u; n++) {
+        auto val = cli.get("mailbox").exec()->wait(5.0);
+        auto actual(val["value"].as<shared_array<const uint8_t>>());
+
+        bool match = actual.size()==nelem;
+        for(size_t i=0u; match && i<actual.size(); i++)
+            match = actual[i]==uint8_t(i);
+        testOk(match, "large array %u", unsigned(n));
+    }
+}
+
+// A header announcing a large message body, which is never sent,
+// must not cause the receiver to allocate the full length.
+void testLargeHeader()
+{
+    testShow()<<__func__;
+
+#ifdef HAVE_MALLINFO2
+    auto heapInUse = []() -> size_t {
+        auto info(mallinfo2());
+        return info.uordblks + info.hblkhd;
+    };
+
+    auto serv = server::Config::isolated().build().start();
+
+    SockAddr addr(SockAddr::loopback(AF_INET, serv.config().tcp_port));
+    evsocket sock(AF_INET, SOCK_STREAM, 0, true);
+    if(connect(sock.sock, &addr->sa, addr.size()))
+        testAbort("Unable to connect to %s", addr.tostring().c_str());
+
+    auto before(heapInUse());
+
+    // CMD_GET from a little endian client, with a ~2 GB body
+    const uint8_t header[8] = {0xca, 2, 0x00, 10, 0x00, 0x00, 0x00, 0x7f};
+    if(send(sock.sock, (const char*)header, sizeof(header), 0)!=sizeof(header))
+        testAbort("Unable to send header");
+
+    size_t grew = 0u;
+    for(size_t i=0u; i<10u && grew < 64u*1024u*1024u; i++) {
+        epicsThreadSleep(0.1);
+        auto now(heapInUse());
+        grew = now > before ? now - before : 0u;
+    }
+    testOk(grew < 64u*1024u*1024u, "heap grew by %zu bytes", grew);
+#else
+    testSkip(1, "No mallinfo2()");
+#endif
+}
+
+void testClientWorkers()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    auto mbox(server::SharedPV::buildReadonly());
+    initial["value"] = 42;
+    mbox.open(initial);
+
+    // two servers, each with several PVs
+    auto serv1 = server::Config::isolated().build();
+    auto serv2 = server::Config::isolated().build();
+    std::vector<std::string> names;
+    for(size_t i=0u; i<8u; i++) {
+        names.push_back(SB()<<"mailbox"<<i);
+        serv1.addPV(names.back(), mbox);
+        names.push_back(SB()<<"other"<<i);
+        serv2.addPV(names.back(), mbox);
+    }
+    serv1.start();
+    serv2.start();
+
+    auto conf(serv1.clientConfig());
+    conf.addressList.push_back(SB()<<"127.0.0.1:"<<serv2.config().udp_port);
+    conf.tcpWorkers = 3u;
+    auto cli(conf.build());
+
+    testEq(cli.config().tcpWorkers, 3u);
+
+    std::vector<std::shared_ptr<client::Operation>> ops;
+    for(auto& name : names) {
+        ops.push_back(cli.get(name).exec());
+    }
+
+    size_t nok = 0u;
+    for(auto& op : ops) {
+        if(op->wait(5.0)["value"].as<int32_t>()==42)
+            nok++;
+    }
+    testEq(nok, names.size());
+
+    // still one connection to each server, regardless of the number of workers
+    auto report(cli.report());
+    if(testEq(report.connections.size(), 2u)) {
+        auto& first = report.connections.front();
+        auto& second = report.connections.back();
+        testNotEq(first.peer, second.peer);
+        testEq(first.channels.size(), 8u);
+        testEq(second.channels.size(), 8u);
+    } else {
+        testSkip(3, "connection count mismatch");
+    }
+}
+
+void testSearchFilter()
+{
+    testShow()<<__func__;
+
+    server::SearchFilter F(16u, ".");
+    testEq(F.size(), 0u);
+    testOk1(!F.test("rec"));
+
+    F.add("rec");
+    F.add("other");
+    testEq(F.size(), 2u);
+    testOk1(F.test("rec"));
+    testOk1(F.test("rec.VAL"));
+    testOk1(F.test("other"));
+    testOk1(!F.test("recX"));
+
+    F.remove("rec");
+    testEq(F.size(), 1u);
+    testOk1(!F.test("rec.VAL"));
+    testOk1(F.test("other.DESC"));
+
+    // with precomputed hash, which is of the full name
+    const char* full = "other.DESC";
+    testOk1(F.test(full, strlen(full), impl::nameHash(full, strlen(full))));
+    testOk1(F.test("other", 5u, impl::nameHash("other", 5u)));
+    testOk1(!F.test("rec", 3u, impl::nameHash("rec", 3u)));
+
+    // over-filled, most names pass
+    testEq(F.capacity(), 16u);
+    std::vector<std::string> names;
+    for(auto i : range(1000u))
+        names.push_back(SB()<<"name"<<i);
+    for(auto& name : names)
+        F.add(name);
+
+    auto nfalse = [&F]() -> size_t {
+        size_t n = 0u;
+        for(auto i : range(1000u))
+            n += F.test(std::string(SB()<<"absent"<<i));
+        return n;
+    };
+    auto before(nfalse());
+
+    F.rebuild(2000u, [&names](const server::SearchFilter::add_fn& add) {
+        add("other");
+        for(auto& name : names)
+            add(name.c_str());
+    });
+    testEq(F.size(), 1001u);
+    testTrue(F.capacity()>=2000u)<<" "<<F.capacity();
+    bool all = F.test("other.VAL");
+    for(auto& name : names)
+        all &= F.test(name);
+    testTrue(all)<<" all names pass after rebuild()";
+    auto after(nfalse());
+    testTrue(after < 10u && after < before)<<" false positives before="<<before<<" after="<<after;
+}
+
+void testStaticSourceFilter()
+{
+    testShow()<<__func__;
+
+    server::StaticSource src(server::StaticSource::build());
+    auto filter(src.source()->searchFilter());
+    auto initial(filter->capacity());
+
+    auto pv(server::SharedPV::buildReadonly());
+    for(auto i : range(2u*initial))
+        src.add(SB()<<"pv"<<i, pv);
+
+    testEq(filter->size(), 2u*initial);
+    testTrue(filter->capacity() >= filter->size())<<" capacity "<<filter->capacity();
+    bool all = true;
+    for(auto i : range(2u*initial))
+        all &= filter->test(std::string(SB()<<"pv"<<i));
+    testTrue(all)<<" all names pass after growth";
+}
+
+struct FilteredSource : public server::Source
+{
+    const std::shared_ptr<server::SearchFilter> filter{std::make_shared<server::SearchFilter>()};
+    server::SharedPV pv{server::SharedPV::buildReadonly()};
+    epicsMutex lock;
+    std::set<std::string> seen;
+    size_t badHash = 0u;
+
+    FilteredSource()
+    {
+        auto initial(nt::NTScalar{TypeCode::Int32}.create());
+        initial["value"] = 7;
+        pv.open(initial);
+        filter->add("mine");
+    }
+
+    virtual std::shared_ptr<const server::SearchFilter> searchFilter() override final
+    {
+        return filter;
+    }
+
+    virtual void onSearch(Search &op) override final
+    {
+        epicsGuard<epicsMutex> G(lock);
+        for(auto& name : op) {
+            seen.insert(name.name());
+            if(name.length()!=strlen(name.name()) || name.hash()!=impl::nameHash(name.name(), name.length()))
+                badHash++;
+            if(strcmp(name.name(), "mine")==0)
+                name.claim();
+        }
+    }
+    virtual void onCreate(std::unique_ptr<server::ChannelControl> &&op) override final
+    {
+        if(op->name()=="mine")
+            pv.attach(std::move(op));
+    }
+};
+
+void testSearchFilterServer()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    auto mbox(server::SharedPV::buildReadonly());
+    initial["value"] = 42;
+    mbox.open(initial);
+
+    auto src(std::make_shared<FilteredSource>());
+
+    auto serv = server::Config::isolated().build()
+            .addPV("mailbox", mbox)
+            .addSource("filtered", src)
+            .start();
+    auto cli = serv.clientConfig().build();
+
+    testEq(cli.get("mailbox").exec()->wait(5.0)["value"].as<int32_t>(), 42);
+    testEq(cli.get("mine").exec()->wait(5.0)["value"].as<int32_t>(), 7);
+    testThrows<client::Timeout>([&cli]() {
+        cli.get("nobody").exec()->wait(1.0);
+    });
+
+    {
+        epicsGuard<epicsMutex> G(src->lock);
+        testEq(src->seen.size(), 1u);
+        testEq(src->seen.count("mine"), 1u);
+        testEq(src->badHash, 0u);
+    }
+
+    auto report(serv.report());
+    testOk(report.nSearchHit>=2u, "nSearchHit=%zu", report.nSearchHit);
+    testOk(report.nSearchMiss>=1u, "nSearchMiss=%zu", report.nSearchMiss);
+}
+
+void testCreateBatch()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    auto mbox(server::SharedPV::buildReadonly());
+    initial["value"] = 42;
+    mbox.open(initial);
+
+    auto serv = server::Config::isolated().build();
+    std::vector<std::string> names;
+    for(size_t i=0u; i<10u; i++) {
+        names.push_back(SB()<<"batch"<<i);
+        serv.addPV(names.back(), mbox);
+    }
+    serv.start();
+
+    testEq(serv.clientConfig().createBatch, 1024u);
+
+    for(unsigned batch : {1u, 3u}) {
+        auto conf(serv.clientConfig());
+        conf.createBatch = batch;
+        auto cli(conf.build());
+
+        std::vector<std::shared_ptr<client::Operation>> ops;
+        for(auto& name : names) {
+            ops.push_back(cli.get(name).exec());
+        }
+
+        size_t nok = 0u;
+        for(auto& op : ops) {
+            if(op->wait(5.0)["value"].as<int32_t>()==42)
+                nok++;
+        }
+        testEq(nok, names.size())<<" createBatch="<<batch;
+    }
+}
+
+void testManyChannels()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    auto mbox(server::SharedPV::buildReadonly());
+    initial["value"] = 42;
+    mbox.open(initial);
+
+    auto serv = server::Config::isolated().build();
+    std::vector<std::string> names;
+    for(size_t i=0u; i<5000u; i++) {
+        names.push_back(SB()<<"many"<<i);
+        serv.addPV(names.back(), mbox);
+    }
+    serv.start();
+
+    auto cli(serv.clientConfig().build());
+
+    std::vector<std::shared_ptr<client::Operation>> ops;
+    for(auto& name : names) {
+        ops.push_back(cli.get(name).exec());
+    }
+
+    size_t nok = 0u;
+    for(auto& op : ops) {
+        if(op->wait(10.0)["value"].as<int32_t>()==42)
+            nok++;
+    }
+    testEq(nok, names.size());
+
+    // names are packed densely into search packets
+    auto report(cli.report());
+    testOk(report.nSearchTx>0u && report.nSearchTx<=names.size()/20u,
+           "nSearchTx=%zu", report.nSearchTx);
+
+    size_t nfound = 0u;
+    bool rtt = !report.searchPeers.empty();
+    for(auto& peer : report.searchPeers) {
+        testDiag("Search peer %s rtt=%g +- %g first=%zu retry=%zu",
+                 peer.peer.c_str(), peer.rtt, peer.rttVar, peer.nFirst, peer.nRetry);
+        nfound += peer.nFirst + peer.nRetry;
+        rtt &= peer.rtt>0.0;
+    }
+    testEq(nfound, names.size());
+    testOk(rtt, "search RTT measured");
+}
+
 } // namespace
 
 MAIN(testget)
 {
-    testPlan(62);
+    testPlan(123);
     testSetup();
     logger_config_env();
     const bool canIPv6 = pvxs::impl::evsocket::canIPv6;
@@ -539,6 +977,18 @@ MAIN(testget)
     Tester().ordering();
     testError(false);
     testError(true);
+    testTCPWorkers();
+    testLargeArray(1024u*1024u);
+    testLargeArray(5u*1024u*1024u);
+    // longer than reserveMax, so received without advance allocation
+    testLargeArray(5u*1024u*1024u, 1024u*1024u);
+    testLargeHeader();
+    testClientWorkers();
+    testSearchFilter();
+    testStaticSourceFilter();
+    testSearchFilterServer();
+    testCreateBatch();
+    testManyChannels();
     cleanup_for_valgrind();
     return testDone();
 }
@@ -13,6 +13,7 @@
 #include <epicsUnitTest.h>
 
 #include <epicsEvent.h>
+#include <epicsThread.h>
 
 #include <pvxs/unittest.h>
 #include <pvxs/log.h>
@@ -359,11 +360,500 @@ struct TestReconn : public BasicTest
     }
 };
 
+// post()s the same Value to all subscribers
+struct FanOutSource : public server::Source {
+    Value prototype;
+
+    std::atomic<size_t> nRunning{0u};
+    epicsEvent change;
+
+    epicsMutex lock;
+    std::vector<std::shared_ptr<server::MonitorControlOp>> subs;
+
+    FanOutSource()
+        :prototype(nt::NTScalar{TypeCode::Int32}.create())
+    {}
+
+    virtual void onSearch(Search &op) override final {
+        for(auto& pv : op) {
+            if(strcmp(pv.name(), "fanout")==0)
+                pv.claim();
+        }
+    }
+
+    virtual void onCreate(std::unique_ptr<server::ChannelControl> &&rop) override final {
+        if(rop->name()!="fanout")
+            return;
+
+        auto op(std::move(rop));
+
+        op->onSubscribe([this](std::unique_ptr<server::MonitorSetupOp>&& mop) {
+            std::shared_ptr<server::MonitorControlOp> ctrl(mop->connect(prototype));
+
+            ctrl->onStart([this](bool start) {
+                if(start)
+                    nRunning++;
+                else
+                    nRunning--;
+                change.signal();
+            });
+
+            epicsGuard<epicsMutex> G(lock);
+            subs.push_back(ctrl);
+        });
+    }
+
+    void waitRunning(size_t n) {
+        while(nRunning!=n) {
+            if(!change.wait(5.0))
+                testAbort("timeout waiting for %zu running", n);
+        }
+    }
+};
+
+void testFanOut()
+{
+    testShow()<<__func__;
+
+    auto src(std::make_shared<FanOutSource>());
+    auto serv(server::Config::isolated().build()
+              .addSource("fanout", src)
+              .start());
+    auto cli(serv.clientConfig().build());
+
+    epicsEvent evtA, evtB;
+    auto subA(cli.monitor("fanout")
+              .maskConnected(true)
+              .event([&evtA](client::Subscription&) { evtA.signal(); })
+              .exec());
+    auto subB(cli.monitor("fanout")
+              .maskConnected(true)
+              .event([&evtB](client::Subscription&) { evtB.signal(); })
+              .exec());
+
+    // queue the same update for both subscriptions while neither can send
+    src->waitRunning(2u);
+    subA->pause();
+    subB->pause();
+    src->waitRunning(0u);
+
+    decltype(src->subs) subs;
+    {
+        epicsGuard<epicsMutex> G(src->lock);
+        subs = src->subs;
+    }
+    testEq(subs.size(), 2u);
+
+    auto update(src->prototype.cloneEmpty());
+    update["value"] = 5;
+    {
+        server::MonitorFanout F(update);
+        for(auto& sub : subs)
+            sub->post(update);
+    }
+
+    subA->resume();
+    subB->resume();
+
+    testEq(BasicTest::pop(subA, evtA)["value"].as<int32_t>(), 5);
+    testEq(BasicTest::pop(subB, evtB)["value"].as<int32_t>(), 5);
+
+    size_t nEncode = 0u, nShared = 0u;
+    for(auto& sub : subs) {
+        server::MonitorStat stat;
+        sub->stats(stat);
+        nEncode += stat.nEncode;
+        nShared += stat.nShared;
+    }
+    testEq(nEncode, 1u)<<" encode once";
+    testEq(nShared, 1u)<<" re-use";
+}
+
+void testSegmented(bool swap)
+{
+    testShow()<<__func__<<" swap="<<swap;
+
+    constexpr size_t nelem = 100000u;
+
+    auto mkarr = [](double scale) -> shared_array<const double> {
+        shared_array<double> arr(nelem);
+        for(size_t i=0u; i<arr.size(); i++)
+            arr[i] = i*scale;
+        return arr.freeze();
+    };
+    auto check = [](const Value& val, double scale) -> bool {
+        auto arr(val["value"].as<shared_array<const double>>());
+        bool match = arr.size()==nelem;
+        for(size_t i=0u; match && i<arr.size(); i++)
+            match = arr[i]==i*scale;
+        return match;
+    };
+
+    auto initial(nt::NTScalar{TypeCode::Float64A}.create());
+    initial["value"] = mkarr(1.0);
+    auto mbox(server::SharedPV::buildMailbox());
+    mbox.open(initial);
+
+    auto sconf(server::Config::isolated());
+    sconf.tcpSegmentSize = 1024u;
+    if(swap)
+        sconf.overrideSendBE(EPICS_BYTE_ORDER!=EPICS_ENDIAN_BIG);
+    auto serv(sconf.build()
+              .addPV("mailbox", mbox)
+              .start());
+
+    auto cconf(serv.clientConfig());
+    cconf.tcpSegmentSize = 1024u;
+    auto cli(cconf.build());
+
+    epicsEvent evtA, evtB;
+    auto subA(cli.monitor("mailbox")
+              .event([&evtA](client::Subscription&) { evtA.signal(); })
+              .exec());
+    auto subB(cli.monitor("mailbox")
+              .event([&evtB](client::Subscription&) { evtB.signal(); })
+              .exec());
+
+    testTrue(check(BasicTest::pop(subA, evtA), 1.0))<<" initial A";
+    testTrue(check(BasicTest::pop(subB, evtB), 1.0))<<" initial B";
+
+    {
+        auto update(initial.cloneEmpty());
+        update["value"] = mkarr(2.0);
+        mbox.post(update);
+    }
+
+    testTrue(check(BasicTest::pop(subA, evtA), 2.0))<<" update A";
+    testTrue(check(BasicTest::pop(subB, evtB), 2.0))<<" update B";
+
+    // large PUT from client
+    cli.put("mailbox")
+            .build([&mkarr](Value&& proto) -> Value {
+                auto val(proto.cloneEmpty());
+                val["value"] = mkarr(3.0);
+                return val;
+            })
+            .exec()->wait(5.0);
+
+    testTrue(check(BasicTest::pop(subA, evtA), 3.0))<<" put A";
+    testTrue(check(cli.get("mailbox").exec()->wait(5.0), 3.0))<<" get";
+}
+
+void testPostBatch()
+{
+    testShow()<<__func__;
+
+    BasicTest T;
+    auto other(server::SharedPV::buildReadonly());
+    auto closed(server::SharedPV::buildReadonly());
+    T.mbox.open(T.initial);
+    other.open(T.initial);
+    T.serv.addPV("other", other);
+    T.serv.start();
+
+    epicsEvent evtB;
+    auto subA(T.cli.monitor("mailbox")
+              .event([&T](client::Subscription&) { T.evt.signal(); })
+              .exec());
+    auto subB(T.cli.monitor("other")
+              .event([&evtB](client::Subscription&) { evtB.signal(); })
+              .exec());
+
+    testEq(BasicTest::pop(subA, T.evt)["value"].as<int32_t>(), 42);
+    testEq(BasicTest::pop(subB, evtB)["value"].as<int32_t>(), 42);
+
+    server::PostBatch batch;
+    {
+        auto update(T.initial.cloneEmpty());
+        update["value"] = 1;
+        batch.post(T.mbox, update);
+        update = T.initial.cloneEmpty();
+        update["alarm.severity"] = 2;
+        batch.post(T.mbox, update);
+        update = T.initial.cloneEmpty();
+        update["value"] = 3;
+        batch.post(other, update);
+    }
+    testEq(batch.size(), 2u)<<" updates to one PV merged";
+
+    {
+        server::PostBatch bad;
+        auto update(T.initial.cloneEmpty());
+        update["value"] = 5;
+        bad.post(other, update);
+        bad.post(closed, update);
+        testThrows<std::logic_error>([&bad]() {
+            bad.commit();
+        })<<" post() to closed PV";
+        testEq(other.fetch()["value"].as<int32_t>(), 42)<<" nothing applied";
+    }
+
+    batch.commit();
+    testTrue(batch.empty());
+
+    auto valA(BasicTest::pop(subA, T.evt));
+    testEq(valA["value"].as<int32_t>(), 1);
+    testEq(valA["alarm.severity"].as<int32_t>(), 2);
+    testEq(BasicTest::pop(subB, evtB)["value"].as<int32_t>(), 3);
+    testFalse(subA->pop())<<" only one update";
+}
+
+// commit() concurrent with close() and re-open() of one PV
+void testPostBatchClose()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    auto stable(server::SharedPV::buildReadonly());
+    auto flaky(server::SharedPV::buildReadonly());
+    stable.open(initial);
+    flaky.open(initial);
+
+    std::atomic<bool> done{false};
+    struct Flapper : public epicsThreadRunable {
+        server::SharedPV& pv;
+        const Value& initial;
+        std::atomic<bool>& done;
+        size_t nFlap = 0u;
+        Flapper(server::SharedPV& pv, const Value& initial, std::atomic<bool>& done)
+            :pv(pv), initial(initial), done(done) {}
+        virtual void run() override final {
+            while(!done) {
+                pv.close();
+                epicsThreadSleep(0.0);
+                pv.open(initial);
+                epicsThreadSleep(0.0);
+                nFlap++;
+            }
+        }
+    } flapper(flaky, initial, done);
+    epicsThread worker(flapper, "flapper", epicsThreadGetStackSize(epicsThreadStackSmall));
+    worker.start();
+
+    // each commit() applies all updates, or none
+    size_t nApplied = 0u, nPartial = 0u;
+    for(int32_t i=1; i<=2000; i++) {
+        server::PostBatch batch;
+        auto update(initial.cloneEmpty());
+        update["value"] = i;
+        batch.post(stable, update);
+        batch.post(flaky, update);
+        bool ok = true;
+        try {
+            batch.commit();
+        } catch(std::logic_error&) {
+            ok = false;
+        }
+        bool applied = stable.fetch()["value"].as<int32_t>()==i;
+        if(ok && applied)
+            nApplied++;
+        else if(ok!=applied)
+            nPartial++;
+    }
+    done = true;
+    worker.exitWait();
+
+    testEq(nPartial, 0u)<<" nApplied="<<nApplied<<" nFlap="<<flapper.nFlap;
+}
+
+// many small updates held back and sent together
+void testFlushDelay()
+{
+    testShow()<<__func__;
+
+    auto initial(nt::NTScalar{TypeCode::Int32}.create());
+    initial["value"] = 0;
+    auto mbox(server::SharedPV::buildReadonly());
+    mbox.open(initial);
+
+    auto sconf(server::Config::isolated());
+    sconf.tcpFlushDelay = 20000u; // 20 ms
+    auto serv(sconf.build()
+              .addPV("mailbox", mbox)
+              .start());
+    auto cli(serv.clientConfig().build());
+
+    epicsEvent evt;
+    auto sub(cli.monitor("mailbox")
+             .record("queueSize", 100)
+             .event([&evt](client::Subscription&) { evt.signal(); })
+             .exec());
+
+    testEq(BasicTest::pop(sub, evt)["value"].as<int32_t>(), 0);
+    (void)serv.report(); // zero counters
+
+    constexpr int32_t nupdate = 20;
+    for(int32_t i=1; i<=nupdate; i++) {
+        auto update(initial.cloneEmpty());
+        update["value"] = i;
+        mbox.post(update);
+    }
+
+    bool inorder = true;
+    for(int32_t i=1; i<=nupdate; i++)
+        inorder &= BasicTest::pop(sub, evt)["value"].as<int32_t>()==i;
+    testTrue(inorder)<<" all updates received";
+
+    auto report(serv.report());
+    testEq(report.connections.size(), 1u);
+    if(!report.connections.empty()) {
+        auto& conn = report.connections.front();
+        testTrue(conn.nFlush>0u && conn.nFlushMsg > conn.nFlush)
+                <<" nFlush="<<conn.nFlush<<" nFlushMsg="<<conn.nFlushMsg<<" nFlushBytes="<<conn.nFlushBytes;
+        // each message counted once
+        testTrue(conn.nFlushBytes >= 8u*conn.nFlushMsg && conn.nFlushBytes <= conn.tx)
+                <<" nFlushBytes="<<conn.nFlushBytes<<" tx="<<conn.tx;
+    } else {
+        testSkip(2, "No connection");
+    }
+}
+
+// one post() to many subscriptions sharing a connection
+void testFanOutMany()
+{
+    testShow()<<__func__;
+
+    BasicTest T;
+    T.mbox.open(T.initial);
+    T.serv.start();
+
+    constexpr size_t nsub = 100u;
+    std::vector<std::shared_ptr<client::Subscription>> subs;
+    for(size_t i=0u; i<nsub; i++) {
+        subs.push_back(T.cli.monitor("mailbox")
+                       .event([&T](client::Subscription&) { T.evt.signal(); })
+                       .exec());
+    }
+
+    // wait until every subscription has seen the expected value
+    auto waitAll = [&T, &subs](int32_t expect) -> size_t {
+        std::vector<bool> seen(subs.size(), false);
+        size_t nseen = 0u;
+        while(nseen < subs.size()) {
+            for(size_t i=0u; i<subs.size(); i++) {
+                while(auto val = subs[i]->pop()) {
+                    if(!seen[i] && val["value"].as<int32_t>()==expect) {
+                        seen[i] = true;
+                        nseen++;
+                    }
+                }
+            }
+            if(nseen < subs.size() && !T.evt.wait(5.0))
+                break;
+        }
+        return nseen;
+    };
+
+    testEq(waitAll(42), nsub);
+    T.serv.report(true); // zero counters
+
+    T.post(43);
+    testEq(waitAll(43), nsub)<<" all subscriptions updated";
+
+    // the updates for every subscription were queued, and sent, as one batch
+    auto report(T.serv.report());
+    testEq(report.connections.size(), 1u);
+    if(!report.connections.empty()) {
+        auto& conn = report.connections.front();
+        testEq(conn.nReplyBatch, 1u);
+        testEq(conn.nReply, nsub);
+    } else {
+        testSkip(2, "No connection");
+    }
+}
+
+// batch pop() into a re-used vector recycles previous updates
+void testBatchRecycle()
+{
+    testShow()<<__func__;
+
+    BasicTest T;
+    T.mbox.open(T.initial);
+    T.serv.start();
+
+    auto sub(T.cli.monitor("mailbox")
+             .record("queueSize", 2)
+             .event([&T](client::Subscription&) { T.evt.signal(); })
+             .exec());
+
+    std::vector<Value> batch;
+    auto round = [&T, &sub, &batch](int32_t v) -> bool {
+        T.post(v);
+        while(true) {
+            bool more = sub->pop(batch);
+            if(!batch.empty() && batch.back()["value"].as<int32_t>()==v)
+                return true;
+            else if(!more && !T.evt.wait(5.0))
+                return false;
+        }
+    };
+
+    bool ok = true;
+    {
+        // hold more updates than the client pool limit of 2*queueSize,
+        // so that the pool is full before counting.
+        std::vector<Value> hold;
+        for(int32_t i=0; i<5; i++) {
+            ok &= round(i);
+            hold.insert(hold.end(), batch.begin(), batch.end());
+        }
+    }
+    // replace any update allocated beyond the pool limit
+    ok &= round(5);
+
+    // report() syncs with the server worker, so the last update has
+    // been sent and released from the server queue.
+    T.serv.report();
+    auto before(instanceSnapshot()["StructTop"]);
+    for(int32_t i=6; i<50; i++)
+        ok &= round(i);
+    T.serv.report();
+    auto after(instanceSnapshot()["StructTop"]);
+
+    testTrue(ok);
+    testEq(before, after)<<" no new updates allocated in steady state";
+}
+
+// deltaOnly() delivers only the fields changed by each update
+void testDeltaOnly()
+{
+    testShow()<<__func__;
+
+    BasicTest T;
+    T.initial["alarm.severity"] = 2;
+    T.mbox.open(T.initial);
+    T.serv.start();
+
+    auto sub(T.cli.monitor("mailbox")
+             .deltaOnly()
+             .event([&T](client::Subscription&) { T.evt.signal(); })
+             .exec());
+
+    if(auto val = BasicTest::pop(sub, T.evt)) {
+        testEq(val["value"].as<int32_t>(), 42);
+        testEq(val["alarm.severity"].as<uint32_t>(), 2u);
+    } else {
+        testFail("Missing data update");
+    }
+
+    T.post(43);
+
+    if(auto val = BasicTest::pop(sub, T.evt)) {
+        testEq(val["value"].as<int32_t>(), 43);
+        testTrue(val["value"].isMarked(false));
+        // not carried over from the previous update
+        testEq(val["alarm.severity"].as<uint32_t>(), 0u);
+        testFalse(val["alarm.severity"].isMarked(false));
+    } else {
+        testFail("Missing data update");
+    }
+}
+
 } // namespace
 
 MAIN(testmon)
 {
-    testPlan(41);
+    testPlan(87);
     testSetup();
     try{
         logger_config_env();
@@ -377,6 +867,15 @@ MAIN(testmon)
         TestLifeCycle().testDelta();
         TestReconn().testReconn(false);
         TestReconn().testReconn(true);
+        testFanOut();
+        testSegmented(false);
+        testSegmented(true);
+        testBatchRecycle();
+        testFanOutMany();
+        testPostBatch();
+        testPostBatchClose();
+        testFlushDelay();
+        testDeltaOnly();
     }catch(std::exception& e) {
         testFail("Unhandled exception %s : %s", typeid(e).name(), e.what());
         throw;
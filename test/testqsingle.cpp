@@ -874,11 +874,47 @@ void testMonitorAIFilt(TestClient& ctxt)
     sub2.testEmpty();
 }
 
+void testMonitorShared(TestClient& ctxt)
+{
+    testDiag("%s", __func__);
+
+    TestSubscription sub1(ctxt.monitor("test:ai")
+                          .maskConnected(true)
+                          .maskDisconnected(true));
+
+    auto val(sub1.waitForUpdate());
+    testFldEq(val, "value", 8.0);
+
+    // joins the running subscription of sub1
+    auto before(instanceSnapshot()["SingleSourceSharedSubscription"]);
+    TestSubscription sub2(ctxt.monitor("test:ai")
+                          .maskConnected(true)
+                          .maskDisconnected(true));
+
+    val = sub2.waitForUpdate();
+    testFldEq(val, "value", 8.0);
+    testFldEq(val, "valueAlarm.highWarningLimit", 7.0);
+    testTrue(val["display.units"].isMarked())<<" complete initial update";
+    auto after(instanceSnapshot()["SingleSourceSharedSubscription"]);
+    testTrue(after <= before)<<" before="<<before<<" after="<<after;
+    sub1.testEmpty();
+
+    testdbPutFieldOk("test:ai", DBR_DOUBLE, 9.0);
+
+    val = sub1.waitForUpdate();
+    testFldEq(val, "value", 9.0);
+    val = sub2.waitForUpdate();
+    testFldEq(val, "value", 9.0);
+
+    sub1.testEmpty();
+    sub2.testEmpty();
+}
+
 } // namespace
 
 MAIN(testqsingle)
 {
-    testPlan(88);
+    testPlan(99);
     testSetup();
     pvxs::logger_config_env();
     generalTimeRegisterCurrentProvider("test", 1, &testTimeCurrent);
@@ -921,6 +957,7 @@ MAIN(testqsingle)
             testMonitorAI(mctxt);
             testMonitorBO(mctxt);
             testMonitorAIFilt(mctxt);
+            testMonitorShared(mctxt);
         }
         timeSim = false;
         testPutBlock();
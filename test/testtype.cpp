@@ -28,6 +28,29 @@ void showSize()
 #undef CASE
 }
 
+void testMemberIndex()
+{
+    testDiag("%s()", __func__);
+
+    impl::MemberIndex idx;
+    testTrue(idx.empty());
+    testTrue(idx.find("a")==idx.end());
+
+    idx.insert("b", 1u);
+    idx.insert("a.x", 2u);
+    idx.insert("b", 3u); // replaces
+    idx.finalize();
+
+    testEq(idx.size(), 2u);
+    testEq(idx.begin()->first, "a.x");
+    testEq(idx.find("b")->second, 3u);
+    testEq(idx.find("a.xyz", 3u)->second, 2u);
+    testTrue(idx.find("a")==idx.end());
+
+    auto copy(idx);
+    testEq(copy.find("a.x")->second, 2u);
+}
+
 void testCode()
 {
     testDiag("%s()", __func__);
@@ -663,9 +686,10 @@ void testAppendBig()
 
 MAIN(testtype)
 {
-    testPlan(71);
+    testPlan(79);
     testSetup();
     showSize();
+    testMemberIndex();
     testCode();
     testBasic();
     testTypeDef();
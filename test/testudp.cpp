@@ -14,6 +14,8 @@
 #include <osiSock.h>
 #include <event2/util.h>
 #include <epicsEvent.h>
+#include <epicsMutex.h>
+#include <epicsGuard.h>
 
 #include <pvxs/log.h>
 #include "evhelper.h"
@@ -22,6 +24,8 @@
 namespace {
 using namespace pvxs;
 
+typedef epicsGuard<epicsMutex> Guard;
+
 void testBeacon(bool be)
 {
     testDiag("In %s", __func__);
@@ -106,6 +110,8 @@ void testSearch(bool be, std::initializer_list<const char*> names)
             size_t i=0;
             for(auto name : msg.names) {
                 testEq(msg.names[i].id, i+1);
+                testEq(msg.names[i].len, strlen(name.name));
+                testEq(msg.names[i].hash, nameHash(name.name, strlen(name.name)));
                 testEq(msg.names[i++].name, name.name);
             }
         }
@@ -146,12 +152,149 @@ void testSearch(bool be, std::initializer_list<const char*> names)
     testOk1(!!rx.wait(30.0));
 }
 
+void testBatchIO()
+{
+    testDiag("In %s", __func__);
+
+    evsocket A(AF_INET, SOCK_DGRAM, 0),
+             B(AF_INET, SOCK_DGRAM, 0),
+             C(AF_INET, SOCK_DGRAM, 0);
+    A.bind(SockAddr::loopback(AF_INET));
+    B.bind(SockAddr::loopback(AF_INET));
+    C.bind(SockAddr::loopback(AF_INET));
+    evutil_make_socket_nonblocking(B.sock);
+    evutil_make_socket_nonblocking(C.sock);
+    SockAddr addrA(A.sockname()), addrB(B.sockname()), addrC(C.sockname());
+
+    // one datagram to two destinations
+    {
+        const char msg[] = "hello";
+        sendmmsgx::Dest dests[2] = {{&addrB}, {&addrC}};
+        sendmmsgx{A.sock, msg, sizeof(msg), dests, 2u}.call();
+        testEq(dests[0].ntx, int(sizeof(msg)));
+        testEq(dests[1].ntx, int(sizeof(msg)));
+    }
+
+    // several datagrams to one destination
+    constexpr unsigned ntotal = 10u;
+    for(unsigned i=0u; i<ntotal; i++) {
+        uint8_t msg[4] = {uint8_t(i), 1, 2, 3};
+        sendmmsgx::Dest dest{&addrB};
+        sendmmsgx{A.sock, msg, 1u+i%4u, &dest, 1u}.call();
+    }
+
+    char bufs[4][16];
+    recvmmsgx::Msg msgs[4];
+    for(size_t i=0u; i<4u; i++) {
+        msgs[i].buf = bufs[i];
+        msgs[i].buflen = sizeof(bufs[i]);
+    }
+
+    {
+        recvmmsgx rx{C.sock, msgs, 4u};
+        testEq(rx.call(), 1);
+        testEq(msgs[0].nrx, 6u);
+        testEq(msgs[0].src, addrA);
+        testOk1(strcmp(bufs[0], "hello")==0);
+    }
+
+    // B has the "hello", then ntotal more
+    unsigned nrx = 0u, nmatch = 0u, ncall = 0u;
+    while(true) {
+        recvmmsgx rx{B.sock, msgs, 4u};
+        int ret = rx.call();
+        if(ret<=0)
+            break;
+        ncall++;
+        for(int i=0; i<ret; i++, nrx++) {
+            if(nrx==0u) {
+                nmatch += msgs[i].nrx==6u;
+            } else {
+                unsigned idx = nrx-1u;
+                nmatch += msgs[i].nrx==1u+idx%4u && uint8_t(bufs[i][0])==idx && msgs[i].src==addrA;
+            }
+        }
+    }
+    testEq(nrx, ntotal+1u);
+    testEq(nmatch, ntotal+1u);
+    testOk(ncall>=3u, "%u calls", ncall);
+
+    {
+        recvmmsgx rx{B.sock, msgs, 4u};
+        testEq(rx.call(), -1);
+    }
+}
+
+void testBeaconStress()
+{
+    testDiag("In %s", __func__);
+
+    SockAddr listener(SockAddr::loopback(AF_INET));
+    SockAddr sender(SockAddr::loopback(AF_INET));
+
+    evsocket sock(AF_INET, SOCK_DGRAM, 0);
+    sock.bind(sender);
+
+    epicsMutex lock;
+    epicsEvent rx;
+    std::vector<unsigned> seen(256u, 0u);
+    unsigned nrx = 0u;
+
+    auto manager = UDPManager::instance();
+    auto sub = manager.onBeacon(listener,
+                                [&](const UDPManager::Beacon& msg)
+    {
+        Guard G(lock);
+        seen.at(msg.guid[0])++;
+        nrx++;
+        rx.signal();
+    });
+    sub->start();
+
+    uint8_t msg[46] = {
+        0xca, pva_version::server, 0, CMD_BEACON,
+        sizeof(msg)-8, 0, 0, 0,
+        // GUID, first byte is a sequence number
+        0, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+        0, 0, 0, 0,
+        0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xff, 0xff, 0, 0, 0, 0,
+        0x34, 0x12,
+        3, 't', 'c', 'p',
+    };
+
+    // send in bursts, which are much larger than a receive batch,
+    // while not overflowing the socket buffer.
+    constexpr unsigned nburst = 16u, burstLen = 16u;
+    bool ok = true;
+    for(unsigned b=0u; b<nburst && ok; b++) {
+        for(unsigned i=0u; i<burstLen; i++) {
+            msg[8] = uint8_t(b*burstLen + i);
+            ok &= sendto(sock.sock, (char*)msg, sizeof(msg), 0, &listener->sa, listener.size())==sizeof(msg);
+        }
+
+        const unsigned expect = (b+1u)*burstLen;
+        while(ok) {
+            {
+                Guard G(lock);
+                if(nrx>=expect)
+                    break;
+            }
+            ok &= rx.wait(10.0);
+        }
+    }
+
+    Guard G(lock);
+    testOk(ok, "Sent and received %u beacons without timeout", nburst*burstLen);
+    testEq(nrx, nburst*burstLen);
+    testEq(unsigned(std::count(seen.begin(), seen.end(), 1u)), nburst*burstLen);
+}
+
 } // namespace
 
 int main(int argc, char *argv[])
 {
     SockAttach attach;
-    testPlan(46);
+    testPlan(71);
     testSetup();
     pvxs::logger_config_env();
     testBeacon(true);
@@ -160,6 +303,8 @@ int main(int argc, char *argv[])
     testSearch(false, {"hello"});
     testSearch(true , {"one", "two"});
     testSearch(false, {"one", "two"});
+    testBatchIO();
+    testBeaconStress();
     cleanup_for_valgrind();
     return testDone();
 }
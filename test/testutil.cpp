@@ -287,11 +287,109 @@ void testOnce()
     testEq(onceCount[1], 1u);
 }
 
+void testRingQueue()
+{
+    testShow()<<__func__;
+
+    RingQueue<std::shared_ptr<int>> Q;
+    Q.reserve(3u);
+    testEq(Q.capacity(), 4u);
+    testTrue(Q.empty());
+
+    // cycle several times around the ring without growing
+    bool ordered = true;
+    for(int i=0; i<10; i++) {
+        Q.emplace_back(std::make_shared<int>(i));
+        if(Q.size()==3u) {
+            ordered &= *Q.front()==i-2;
+            Q.pop_front();
+        }
+    }
+    testTrue(ordered);
+    testEq(Q.capacity(), 4u)<<" no growth";
+    testEq(*Q.back(), 9);
+
+    auto ref(std::make_shared<int>(0));
+    Q.push_back(std::shared_ptr<int>(ref));
+    testEq(ref.use_count(), 2u);
+    Q.clear();
+    testTrue(Q.empty());
+    testEq(ref.use_count(), 1u)<<" popped entries released";
+
+    // grow while wrapped preserves order
+    for(int i=0; i<3; i++)
+        Q.emplace_back(std::make_shared<int>(i));
+    Q.pop_front();
+    Q.pop_front();
+    for(int i=3; i<10; i++)
+        Q.emplace_back(std::make_shared<int>(i));
+    testEq(Q.capacity(), 8u);
+    testEq(Q.size(), 8u);
+    testEq(*Q.back(), 9);
+    ordered = true;
+    for(int i=2; i<10; i++) {
+        ordered &= *Q.front()==i;
+        Q.pop_front();
+    }
+    testTrue(ordered)<<" order preserved across growth";
+    testTrue(Q.empty());
+}
+
+void testNameIndex()
+{
+    testShow()<<__func__;
+
+    NameIndex<int> idx;
+    testTrue(idx.empty());
+    testTrue(!idx.find("missing"));
+
+    testTrue(idx.insert("one", 1).second);
+    testTrue(idx.insert("two", 2).second);
+    testFalse(idx.insert("one", 3).second)<<" no duplicate";
+    testEq(idx.size(), 2u);
+    if(auto val = idx.find("one"))
+        testEq(*val, 1);
+    else
+        testFail("one not found");
+
+    // lookup w/ precomputed hash, and name not nil terminated
+    const char buf[] = "twox";
+    testTrue(idx.find(buf, 3u, nameHash(buf, 3u))!=nullptr);
+    testTrue(!idx.find(buf, 4u, nameHash(buf, 4u)));
+
+    testTrue(idx.erase("one"));
+    testFalse(idx.erase("one"));
+    testTrue(!idx.find("one"));
+    testTrue(idx.find("two")!=nullptr)<<" found past erased entry";
+
+    // grow, with many erased entries along the way
+    for(int i=0; i<1000; i++) {
+        idx.insert(SB()<<"pv"<<i, i);
+        if(i%2)
+            idx.erase(SB()<<"pv"<<(i-1));
+    }
+    testEq(idx.size(), 501u);
+    bool match = true;
+    for(int i=0; i<1000; i++) {
+        auto val = idx.find(SB()<<"pv"<<i);
+        match &= (i%2) ? val && *val==i : !val;
+    }
+    testTrue(match)<<" after growth";
+
+    size_t nvisit = 0u;
+    idx.visit([&nvisit](const std::string&, int&) { nvisit++; });
+    testEq(nvisit, 501u);
+
+    idx.clear();
+    testTrue(idx.empty());
+    testTrue(!idx.find("two"));
+}
+
 } // namespace
 
 MAIN(testutil)
 {
-    testPlan(35);
+    testPlan(66);
     testTrue(version_abi_check())<<" 0x"<<std::hex<<PVXS_VERSION<<" ~= 0x"<<std::hex<<PVXS_ABI_VERSION;
     testServerGUID();
     testFill();
@@ -301,5 +399,7 @@ MAIN(testutil)
     testTestEq();
     testStrDiff();
     testOnce();
+    testRingQueue();
+    testNameIndex();
     return testDone();
 }
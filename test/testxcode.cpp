@@ -14,6 +14,7 @@
 #include <pvxs/nt.h>
 #include "dataimpl.h"
 #include "pvaproto.h"
+#include "evhelper.h"
 
 namespace {
 using namespace pvxs;
@@ -601,6 +602,202 @@ void testArrayXCode()
     testArrayXCodeT<std::string>("\x01\x02\x02\x05hello\x05world", {"hello", "world"});
 }
 
+void testBSwapKernels()
+{
+    testDiag("%s", __func__);
+
+    for(auto& K : bswap_kernels())
+        testDiag("Kernel %s", K.name);
+
+    // odd lengths, and unaligned src and dest, to exercise vector and scalar tail handling
+    std::vector<uint8_t> src(1u + 8u*67u), dest(src.size()+1u);
+    for(auto i : range(src.size()))
+        src[i] = uint8_t(i*7u + 3u);
+
+    for(size_t esize : {2u, 4u, 8u}) {
+        bool ok = true;
+        for(auto& K : bswap_kernels()) {
+            auto fn = esize==2u ? K.swap2 : esize==4u ? K.swap4 : K.swap8;
+
+            for(size_t nelem=0u; nelem<=67u; nelem++) {
+                std::fill(dest.begin(), dest.end(), 0xa5);
+                (*fn)(dest.data()+1u, src.data()+1u, nelem);
+
+                for(size_t i=0u; i<nelem*esize; i++) {
+                    auto expect = src[1u + (i/esize)*esize + esize-1u-(i%esize)];
+                    if(dest[1u+i]!=expect) {
+                        testDiag("%s esize=%u nelem=%u mismatch at %u",
+                                 K.name, unsigned(esize), unsigned(nelem), unsigned(i));
+                        ok = false;
+                        break;
+                    }
+                }
+                // no overrun
+                if(dest[0]!=0xa5 || dest[1u+nelem*esize]!=0xa5) {
+                    testDiag("%s esize=%u nelem=%u overrun", K.name, unsigned(esize), unsigned(nelem));
+                    ok = false;
+                }
+            }
+        }
+        testOk(ok, "kernels for esize=%u", unsigned(esize));
+    }
+
+    // round trip through swapped byte order
+    shared_array<uint32_t> arr(1001u);
+    for(auto i : range(arr.size()))
+        arr[i] = uint32_t(i*0x01020304u);
+    auto carr(arr.freeze().castTo<const void>());
+
+    std::vector<uint8_t> buf(5u + 4u*1001u);
+    {
+        FixedBuf M(!hostBE, buf);
+        to_wire<uint32_t>(M, carr);
+        testOk1(M.good() && M.empty());
+    }
+    testEq(buf[5], uint8_t(0u)); // 0x00000000
+    testEq(buf[9], hostBE ? uint8_t(0x04u) : uint8_t(0x01u)); // 0x01020304 as LSB or MSB first
+    {
+        FixedBuf M(!hostBE, buf);
+        shared_array<const void> out;
+        from_wire<uint32_t>(M, out);
+        testOk1(M.good() && M.empty());
+        auto actual(out.castTo<const uint32_t>());
+        bool match = actual.size()==1001u;
+        for(size_t i=0u; match && i<actual.size(); i++)
+            match = actual[i]==uint32_t(i*0x01020304u);
+        testOk(match, "swapped round trip");
+    }
+}
+
+void testValidDecoder()
+{
+    testDiag("%s", __func__);
+
+    auto proto(nt::NTScalar{TypeCode::Float64A}.create());
+
+    shared_array<double> arr(1001u);
+    for(auto i : range(arr.size()))
+        arr[i] = i*1.5;
+
+    auto val(proto.cloneEmpty());
+    val["value"] = arr.freeze();
+    val["alarm.message"] = "hello";
+    val["timeStamp.secondsPastEpoch"] = 1234;
+
+    for(bool be : {true, false}) {
+        std::vector<uint8_t> buf;
+        {
+            VectorOutBuf S(be, buf);
+            to_wire_valid(S, val);
+            buf.resize(S.consumed());
+        }
+
+        auto expect(proto.cloneEmpty());
+        {
+            TypeStore ctxt;
+            FixedBuf S(be, buf);
+            from_wire_valid(S, ctxt, expect);
+            testOk1(S.good() && S.empty());
+        }
+        std::string expectStr(SB()<<expect);
+
+        for(size_t chunk : {1u, 3u, 7u, 64u, 100000u}) {
+            auto actual(proto.cloneEmpty());
+            TypeStore ctxt;
+            ValidDecoder dec(ctxt, actual);
+            evbuf ebuf(__FILE__, __LINE__, evbuffer_new());
+
+            // decoding may only complete with the last chunk
+            bool early = false, done = false;
+            for(size_t off=0u; off<buf.size(); off+=chunk) {
+                auto n = std::min(chunk, buf.size()-off);
+                evbuffer_add(ebuf.get(), buf.data()+off, n);
+                bool last = off+n==buf.size();
+                done = dec.decode(ebuf.get(), be, last);
+                early |= done && !last;
+            }
+
+            testTrue(done && !early && dec.good()
+                     && evbuffer_get_length(ebuf.get())==0u
+                     && actual["value"].isMarked() && actual["alarm.message"].isMarked()
+                     && !actual["alarm.severity"].isMarked()
+                     && expectStr==std::string(SB()<<actual))
+                    <<" be="<<be<<" chunk="<<chunk;
+        }
+    }
+
+    {
+        // truncated
+        std::vector<uint8_t> buf;
+        {
+            VectorOutBuf S(true, buf);
+            to_wire_valid(S, val);
+            buf.resize(S.consumed() - 1u);
+        }
+        auto actual(proto.cloneEmpty());
+        TypeStore ctxt;
+        ValidDecoder dec(ctxt, actual);
+        evbuf ebuf(__FILE__, __LINE__, evbuffer_new());
+        evbuffer_add(ebuf.get(), buf.data(), buf.size());
+        testTrue(dec.decode(ebuf.get(), true, true) && !dec.good())<<" truncated faults";
+    }
+}
+
+void testValidDecoderUnion()
+{
+    testDiag("%s", __func__);
+
+    auto proto(nt::NTNDArray{}.create());
+
+    shared_array<uint16_t> arr(4000u);
+    for(auto i : range(arr.size()))
+        arr[i] = uint16_t(i*3u);
+
+    auto val(proto.cloneEmpty());
+    val["value->ushortValue"] = arr.freeze();
+    val["uniqueId"] = 42;
+    val["codec.name"] = "";
+
+    for(bool be : {true, false}) {
+        std::vector<uint8_t> buf;
+        {
+            VectorOutBuf S(be, buf);
+            to_wire_valid(S, val);
+            buf.resize(S.consumed());
+        }
+
+        auto expect(proto.cloneEmpty());
+        {
+            TypeStore ctxt;
+            FixedBuf S(be, buf);
+            from_wire_valid(S, ctxt, expect);
+            testOk1(S.good() && S.empty());
+        }
+        std::string expectStr(SB()<<expect);
+
+        const size_t chunk = 1000u;
+        auto actual(proto.cloneEmpty());
+        TypeStore ctxt;
+        ValidDecoder dec(ctxt, actual);
+        evbuf ebuf(__FILE__, __LINE__, evbuffer_new());
+
+        // the selected array is filled as it arrives, so little input remains buffered
+        bool done = false;
+        size_t maxPending = 0u;
+        for(size_t off=0u; off<buf.size(); off+=chunk) {
+            auto n = std::min(chunk, buf.size()-off);
+            evbuffer_add(ebuf.get(), buf.data()+off, n);
+            done = dec.decode(ebuf.get(), be, off+n==buf.size());
+            maxPending = std::max(maxPending, evbuffer_get_length(ebuf.get()));
+        }
+
+        testTrue(done && dec.good()
+                 && maxPending < chunk
+                 && expectStr==std::string(SB()<<actual))
+                <<" be="<<be<<" maxPending="<<maxPending;
+    }
+}
+
 /*  epics:nt/NTScalarArray:1.0
  *      double[] value
  *      alarm_t alarm
@@ -1218,7 +1415,7 @@ void testEmptyRequest()
 
 MAIN(testxcode)
 {
-    testPlan(143);
+    testPlan(168);
     testSetup();
     testDeserializeString();
     testSerialize1();
@@ -1229,6 +1426,9 @@ MAIN(testxcode)
     testDeserialize3();
     testDecode1();
     testArrayXCode();
+    testBSwapKernels();
+    testValidDecoder();
+    testValidDecoderUnion();
     testXCodeNTScalar();
     testXCodeNTNDArray();
     testRegressRedundantBitMask();